@@ -0,0 +1,165 @@
+/**********************************************************************
+ *
+ *  generate_unicode_property.c
+ *
+ *  Writes src/unicode_property.h, the two-stage table of Unicode
+ *  character properties described in src/unicode.h, to standard output.
+ *  The general category and lowercase form of each character are taken
+ *  from utf8proc, the word break property from word_break_property.h
+ *  and the character class from charclass_range.h.
+ *
+ * Copyright 2026 ocreval contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You
+ * may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ **********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <utf8proc.h>
+
+#include "charclass.h"
+#include "unicode.h"
+
+#define WORD_BREAK_RANGES
+#include "word_break_property.h"
+
+#include "charclass_range.h"
+
+#define NUM_CODE_POINTS   0x110000
+#define RECORDS_PER_LINE  4
+
+static Uniprop property[NUM_CODE_POINTS];
+
+static unsigned short page[UNICODE_NUM_PAGES];
+static long leaf[UNICODE_NUM_PAGES];
+                        /* first page of each distinct leaf */
+static long num_leaves;
+
+static char *class_name[MAX_CHARCLASSES];
+static int num_classes;
+
+/**********************************************************************/
+
+static void fail(message)
+char *message;
+{
+    fprintf(stderr, "generate_unicode_property: %s\n", message);
+    exit(EXIT_FAILURE);
+}
+/**********************************************************************/
+
+static void find_properties()
+{
+    long c, j;
+    size_t i;
+    for (c = 0; c < NUM_CODE_POINTS; c++)
+    {
+	property[c].category = utf8proc_category((utf8proc_int32_t) c);
+	property[c].lowercase = utf8proc_tolower((utf8proc_int32_t) c) - c;
+	property[c].word_break = Other;
+	property[c].charclass = 0;
+    }
+    for (i = 0; i < sizeof(WORD_BREAK_PROPERTY) / sizeof(wb_range); i++)
+	for (c = WORD_BREAK_PROPERTY[i].start; c <= WORD_BREAK_PROPERTY[i].end;
+	c++)
+	    property[c].word_break = WORD_BREAK_PROPERTY[i].value;
+    for (i = 0; i < sizeof(range) / sizeof(struct range); i++)
+    {
+	for (j = 0; j < num_classes && strcmp(range[i].name, class_name[j]) != 0;
+	j++);
+	if (j == num_classes)
+	{
+	    if (num_classes == MAX_CHARCLASSES)
+		fail("too many character classes");
+	    class_name[num_classes++] = range[i].name;
+	}
+	for (c = range[i].start; c <= range[i].stop; c++)
+	    property[c].charclass = j;
+    }
+}
+/**********************************************************************/
+
+static int same_page(page1, page2)
+long page1, page2;
+{
+    Uniprop *p1 = &property[page1 << UNICODE_LEAF_SHIFT];
+    Uniprop *p2 = &property[page2 << UNICODE_LEAF_SHIFT];
+    long i;
+    for (i = 0; i < UNICODE_LEAF_SIZE; i++)
+	if (p1[i].lowercase != p2[i].lowercase ||
+	p1[i].category != p2[i].category ||
+	p1[i].word_break != p2[i].word_break ||
+	p1[i].charclass != p2[i].charclass)
+	    return(0);
+    return(1);
+}
+/**********************************************************************/
+
+static void find_leaves()
+{
+    long p, l;
+    for (p = 0; p < UNICODE_NUM_PAGES; p++)
+    {
+	for (l = 0; l < num_leaves && !same_page(leaf[l], p); l++);
+	if (l == num_leaves)
+	    leaf[num_leaves++] = p;
+	if (l > 0xFFFF)
+	    fail("too many leaves");
+	page[p] = l;
+    }
+}
+/**********************************************************************/
+
+static void write_header()
+{
+    long i, l;
+    Uniprop *p;
+    printf("/* AUTOGENERATED FILE! DO NOT MODIFY.\n");
+    printf(" * See libexec/generate_unicode_property.c */\n\n");
+
+    printf("char *unicode_charclass_name[] =\n{\n");
+    for (i = 0; i < num_classes; i++)
+	printf("    \"%s\"%s\n", class_name[i], i + 1 < num_classes ? "," : "");
+    printf("};\n\n");
+    printf("const short unicode_num_charclasses = %d;\n\n", num_classes);
+
+    printf("const unsigned short unicode_page[UNICODE_NUM_PAGES] =\n{");
+    for (i = 0; i < UNICODE_NUM_PAGES; i++)
+	printf("%s%s%d", i > 0 ? "," : "", i % 12 == 0 ? "\n    " : " ",
+	page[i]);
+    printf("\n};\n\n");
+
+    printf("const Uniprop unicode_leaf[][UNICODE_LEAF_SIZE] =\n{\n");
+    for (l = 0; l < num_leaves; l++)
+    {
+	printf("    {");
+	p = &property[leaf[l] << UNICODE_LEAF_SHIFT];
+	for (i = 0; i < UNICODE_LEAF_SIZE; i++)
+	    printf("%s%s{%ld, %d, %d, %d}", i > 0 ? "," : "",
+	    i % RECORDS_PER_LINE == 0 ? "\n\t" : " ", (long) p[i].lowercase,
+	    p[i].category, p[i].word_break, p[i].charclass);
+	printf("\n    }%s\n", l + 1 < num_leaves ? "," : "");
+    }
+    printf("};\n");
+}
+/**********************************************************************/
+
+int main()
+{
+    find_properties();
+    find_leaves();
+    write_header();
+    return(EXIT_SUCCESS);
+}
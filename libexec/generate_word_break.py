@@ -17,8 +17,9 @@
 
 """
 Parses WordBreakProperty.txt and generates a binary search table as a C header
-file. Note! This header file must be included only ONCE in only ONE
-translation unit (i.e. C file).
+file. The table is defined only if WORD_BREAK_RANGES is defined, so that the
+enum may be used anywhere. Note! The table must be included only ONCE in only
+ONE translation unit (i.e. C file).
 """
 
 import os
@@ -44,9 +45,11 @@ typedef enum {
 '''
 
 TABLE_TEMP = '''\
+#ifdef WORD_BREAK_RANGES
 static const wb_range WORD_BREAK_PROPERTY[] = {
     %s
 };
+#endif
 '''
 
 CATEGORY_NAMES = '''\
@@ -109,7 +112,7 @@ def parse_line(line):
 
 def parse_lines(word_break_file):
     for line in word_break_file:
-        contents = parse_line(line)
+        contents = parse_line(line.decode('UTF-8'))
         if contents is None:
             continue
         else:
@@ -28,6 +28,7 @@
 #include <utf8proc.h>
 
 #include "accrpt.h"
+#include "output.h"
 #include "sort.h"
 #include "ocreval_version.h"
 
@@ -89,14 +90,14 @@ long errors, marked;
 /**********************************************************************/
 
 static Boolean read_line(f)
-FILE *f;
+gzFile f;
 {
-    return(fgets(line, sizeof(line) - 1, f) ? True : False);
+    return(gzgets(f, line, sizeof(line) - 1) ? True : False);
 }
 /**********************************************************************/
 
 static Boolean read_value(f, value, sum_value)
-FILE *f;
+gzFile f;
 long *value, *sum_value;
 {
     if (read_line(f) && sscanf(line, "%ld", value) == 1)
@@ -110,7 +111,7 @@ long *value, *sum_value;
 /**********************************************************************/
 
 static Boolean read_ops(f, sum_ops)
-FILE *f;
+gzFile f;
 Accops *sum_ops;
 {
     Accops ops;
@@ -129,7 +130,7 @@ Accops *sum_ops;
 /**********************************************************************/
 
 static Boolean read_two(f, value1, value2)
-FILE *f;
+gzFile f;
 long *value1, *value2;
 {
     return(read_line(f) && sscanf(line, "%ld %ld", value1, value2) == 2 ?
@@ -215,10 +216,10 @@ void read_accrpt(accdata, filename)
 Accdata *accdata;
 char *filename;
 {
-    FILE *f;
+    gzFile f;
     long characters, errors, value1, value2;
     Charvalue value3;
-    f = open_file(filename, "r");
+    f = open_gzfile(filename);
     if (read_line(f) && strncmp(line, TITLE, sizeof(TITLE) - 3) == 0 &&
     read_line(f) && strcmp(line, DIVIDER) == 0 &&
     read_value(f, &characters, &accdata->characters) &&
@@ -250,64 +251,86 @@ char *filename;
     }
     else
         error_string("invalid format in", (filename ? filename : "stdin"));
-    close_file(f);
+    close_gzfile(f);
 }
 /**********************************************************************/
 
-static void write_value(f, value, string)
-FILE *f;
+static void write_value(output, value, string)
+Output *output;
 long value;
 char *string;
 {
-    fprintf(f, "%8ld   %s\n", value, string);
+    output_long(output, value, 8);
+    output_string(output, "   ");
+    output_string(output, string);
+    OUTPUT_BYTE(output, '\n');
 }
 /**********************************************************************/
 
-static void write_pct(f, numerator, denominator)
-FILE *f;
+static void write_pct(output, numerator, denominator)
+Output *output;
 long numerator, denominator;
 {
     if (denominator == 0)
-        fprintf(f, "  ------");
+        output_string(output, "  ------");
     else
-        fprintf(f, "%8.2f", 100.0 * numerator / denominator);
+        output_fixed(output, 100.0 * numerator / denominator, 8, 2);
 }
 /**********************************************************************/
 
-static void write_ops(f, ops, string)
-FILE *f;
+static void write_ops(output, ops, string)
+Output *output;
 Accops *ops;
 char *string;
 {
-    fprintf(f, "%8ld %8ld %8ld %8ld   %s\n", ops->ins, ops->subst, ops->del,
-    ops->errors, string);
+    output_long(output, ops->ins, 8);
+    OUTPUT_BYTE(output, ' ');
+    output_long(output, ops->subst, 8);
+    OUTPUT_BYTE(output, ' ');
+    output_long(output, ops->del, 8);
+    OUTPUT_BYTE(output, ' ');
+    output_long(output, ops->errors, 8);
+    output_string(output, "   ");
+    output_string(output, string);
+    OUTPUT_BYTE(output, '\n');
 }
 /**********************************************************************/
 
-static void write_class(f, class, string, value)
-FILE *f;
+static void write_class(output, class, string, value)
+Output *output;
 Accclass *class;
 char *string;
 Charvalue value;
 {
-    char buffer[STRING_SIZE];
-    fprintf(f, "%8ld %8ld ", class->count, class->missed);
-    write_pct(f, class->count - class->missed, class->count);
+    output_long(output, class->count, 8);
+    OUTPUT_BYTE(output, ' ');
+    output_long(output, class->missed, 8);
+    OUTPUT_BYTE(output, ' ');
+    write_pct(output, class->count - class->missed, class->count);
     if (string)
-        fprintf(f, "   %s\n", string);
+    {
+        output_string(output, "   ");
+        output_string(output, string);
+    }
     else
     {
-        char_to_string(False, value, buffer, True);
-        fprintf(f, "   {%s}\n", buffer);
+        output_string(output, "   {");
+        output_char(output, False, value, True);
+        OUTPUT_BYTE(output, '}');
     }
+    OUTPUT_BYTE(output, '\n');
 }
 /**********************************************************************/
 
-static void write_conf(f, conf)
-FILE *f;
+static void write_conf(output, conf)
+Output *output;
 Conf *conf;
 {
-    fprintf(f, "%8ld %8ld   %s", conf->errors, conf->marked, conf->key);
+    output_long(output, conf->errors, 8);
+    OUTPUT_BYTE(output, ' ');
+    output_long(output, conf->marked, 8);
+    output_string(output, "   ");
+    output_string(output, conf->key);
 }
 /**********************************************************************/
 
@@ -326,46 +349,65 @@ void write_accrpt(accdata, filename)
 Accdata *accdata;
 char *filename;
 {
-    FILE *f;
+    Output output;
     long i;
-    f = open_file(filename, "w");
-    fprintf(f, "%s%s", TITLE, DIVIDER);
-    write_value(f, accdata->characters, "Characters");
-    write_value(f, accdata->errors, "Errors");
-    write_pct(f, accdata->characters - accdata->errors, accdata->characters);
-    fprintf(f, "%%  Accuracy\n\n");
-    write_value(f, accdata->reject_characters, "Reject Characters");
-    write_value(f, accdata->suspect_markers, "Suspect Markers");
-    write_value(f, accdata->false_marks, "False Marks");
-    write_pct(f, accdata->reject_characters + accdata->suspect_markers,
+    open_output(&output, filename);
+    output_string(&output, TITLE);
+    output_string(&output, DIVIDER);
+    write_value(&output, accdata->characters, "Characters");
+    write_value(&output, accdata->errors, "Errors");
+    write_pct(&output, accdata->characters - accdata->errors,
     accdata->characters);
-    fprintf(f, "%%  Characters Marked\n");
-    write_pct(f, accdata->characters - accdata->unmarked_ops.errors,
+    output_string(&output, "%  Accuracy\n\n");
+    write_value(&output, accdata->reject_characters, "Reject Characters");
+    write_value(&output, accdata->suspect_markers, "Suspect Markers");
+    write_value(&output, accdata->false_marks, "False Marks");
+    write_pct(&output, accdata->reject_characters + accdata->suspect_markers,
     accdata->characters);
-    fprintf(f, "%%  Accuracy After Correction\n");
-    fprintf(f, "\n     Ins    Subst      Del   Errors\n");
-    write_ops(f, &accdata->marked_ops, "Marked");
-    write_ops(f, &accdata->unmarked_ops, "Unmarked");
-    write_ops(f, &accdata->total_ops, "Total");
-    fprintf(f, "\n   Count   Missed   %%Right\n");
+    output_string(&output, "%  Characters Marked\n");
+    write_pct(&output, accdata->characters - accdata->unmarked_ops.errors,
+    accdata->characters);
+    output_string(&output, "%  Accuracy After Correction\n");
+    output_string(&output, "\n     Ins    Subst      Del   Errors\n");
+    write_ops(&output, &accdata->marked_ops, "Marked");
+    write_ops(&output, &accdata->unmarked_ops, "Unmarked");
+    write_ops(&output, &accdata->total_ops, "Total");
+    output_string(&output, "\n   Count   Missed   %Right\n");
     for (i = 0; i < MAX_CHARCLASSES; i++)
         if (accdata->large_class[i].count > 0)
-            write_class(f, &accdata->large_class[i], charclass_name(i), 0);
-    write_class(f, &accdata->total_class, "Total", 0);
+            write_class(&output, &accdata->large_class[i], charclass_name(i),
+            0);
+    write_class(&output, &accdata->total_class, "Total", 0);
     if (accdata->errors > 0)
     {
         table_in_array(&accdata->conftable);
         sort(accdata->conftable.count, accdata->conftable.array, compare_conf);
-        fprintf(f, "\n  Errors   Marked   Correct-Generated\n");
+        output_string(&output, "\n  Errors   Marked   Correct-Generated\n");
         for (i = 0; i < accdata->conftable.count; i++)
-            write_conf(f, accdata->conftable.array[i]);
+            write_conf(&output, accdata->conftable.array[i]);
     }
     if (accdata->characters > 0)
     {
-        fprintf(f, "\n   Count   Missed   %%Right\n");
+        output_string(&output, "\n   Count   Missed   %Right\n");
         for (i = 0; i < NUM_CHARVALUES; i++)
             if (accdata->small_class[i].count > 0)
-                write_class(f, &accdata->small_class[i], NULL, i);
+                write_class(&output, &accdata->small_class[i], NULL, i);
     }
-    close_file(f);
+    close_output(&output);
+}
+/**********************************************************************/
+
+void write_exceeded_accrpt(characters, max_errors, filename)
+long characters, max_errors;
+char *filename;
+{
+    Output output;
+    open_output(&output, filename);
+    output_string(&output, TITLE);
+    output_string(&output, DIVIDER);
+    write_value(&output, characters, "Characters");
+    OUTPUT_BYTE(&output, '>');
+    output_long(&output, max_errors, 7);
+    output_string(&output, "   Errors (threshold exceeded)\n");
+    close_output(&output);
 }
@@ -91,14 +91,23 @@ void add_conf(/* Accdata *accdata, char *key, long errors, long marked */);
 			   string is stored in the table */
 
 void read_accrpt(/* Accdata *accdata, char *filename */);
-			/* reads the named file (or stdin if "filename" is NULL)
-			   and adds its contents to "accdata"; reports an error
-			   and quits if unable to open the file, or if the file
-			   does not contain an accuracy report */
+			/* reads the named file (or stdin if "filename" is NULL),
+			   which may be gzip-compressed, and adds its contents
+			   to "accdata"; reports an error and quits if unable to
+			   open the file, or if the file does not contain
+			   an accuracy report */
 
 void write_accrpt(/* Accdata *accdata, char *filename */);
 			/* writes the contents of "accdata" to the named file
 			   (or stdout if "filename" is NULL); reports an error
 			   and quits if unable to create the file */
 
+void write_exceeded_accrpt(/* long characters, long max_errors,
+                              char *filename */);
+			/* writes a short report to the named file (or stdout
+			   if "filename" is NULL) stating only that more than
+			   "max_errors" errors were made on "characters"
+			   ground-truth characters; this report cannot be read
+			   by "read_accrpt" */
+
 #endif
@@ -25,7 +25,10 @@
 #include "accrpt.h"
 #include "sync.h"
 
-#define usage  "correctfile generatedfile [accuracy_report]"
+#define usage  "[-a | -b | -l | -u] [-k maxerrors] [-t threads] [-x maxcost] correctfile generatedfile [accuracy_report]\n" \
+"Exits with status 2, after a short report, if -k maxerrors is exceeded"
+
+#define EXCEEDED_STATUS  2
 
 #define MAX_DISPLAY  24
 
@@ -35,20 +38,37 @@ Text text[2];
 
 Accdata accdata;
 
+Boolean anchored, bit_parallel, diagonal, lines;
+
+char *maxerrorstring, *maxcoststring, *threadstring;
+
+Option option[] =
+{
+    { 'a', NULL, &anchored },
+    { 'b', NULL, &bit_parallel },
+    { 'l', NULL, &lines },
+    { 'u', NULL, &diagonal },
+    { 'k', &maxerrorstring, NULL },
+    { 't', &threadstring, NULL },
+    { 'x', &maxcoststring, NULL },
+    { '\0' }
+};
+
 /**********************************************************************/
 
-void make_key(key, sync)
+void make_key(key, array, k)
 char *key;
-Sync *sync;
+Syncarray *array;
+long k;
 {
     long i, j;
     char buffer[2][MAX_DISPLAY + 4], string[STRING_SIZE];
     for (i = 0; i < 2; i++)
     {
 	buffer[i][0] = '\0';
-	for (j = sync->substr[i].start; j <= sync->substr[i].stop; j++)
+	for (j = array->start[i][k]; j <= array->stop[i][k]; j++)
 	{
-	    char_to_string(False, text[i].array[j]->value, string, True);
+	    char_to_string(False, TEXT_VALUE(&text[i], j), string, True);
 	    if (strlen(buffer[i]) + strlen(string) > MAX_DISPLAY)
 	    {
 		strcat(buffer[i], "...");
@@ -71,39 +91,38 @@ Accops *sum_ops, *ops;
 }
 /**********************************************************************/
 
-void process_synclist(synclist)
-Synclist *synclist;
+void process_syncarray(array)
+Syncarray *array;
 {
-    Sync *sync;
-    long i, characters, wildcards, reject_characters, suspect_markers, genchars;
+    long k, i, characters, wildcards, reject_characters, suspect_markers, genchars;
     Accops ops;
     char key[100];
-    for (sync = synclist->first; sync; sync = sync->next)
+    for (k = 0; k < array->count; k++)
     {
 	characters = wildcards = 0;
-	for (i = sync->substr[0].start; i <= sync->substr[0].stop; i++)
-	    if (text[0].array[i]->value == REJECT_CHARACTER)
+	for (i = array->start[0][k]; i <= array->stop[0][k]; i++)
+	    if (TEXT_VALUE(&text[0], i) == REJECT_CHARACTER)
 		wildcards++;
 	    else
 	    {
 		characters++;
-		add_class(&accdata, text[0].array[i]->value, 1,
-		(sync->match ? 0 : 1));
+		add_class(&accdata, TEXT_VALUE(&text[0], i), 1,
+		(array->match[k] ? 0 : 1));
 	    }
 	accdata.characters += characters;
 	reject_characters = suspect_markers = 0;
-	for (i = sync->substr[1].start; i <= sync->substr[1].stop; i++)
-	    if (text[1].array[i]->value == REJECT_CHARACTER)
+	for (i = array->start[1][k]; i <= array->stop[1][k]; i++)
+	    if (TEXT_VALUE(&text[1], i) == REJECT_CHARACTER)
 		reject_characters++;
-	    else if (text[1].array[i]->suspect)
+	    else if (TEXT_SUSPECT(&text[1], i))
 		suspect_markers++;
 	accdata.reject_characters += reject_characters;
 	accdata.suspect_markers += suspect_markers;
-	if (sync->match)
+	if (array->match[k])
 	    accdata.false_marks += suspect_markers;
 	else
 	{
-	    genchars = max(0, sync->substr[1].length - wildcards);
+	    genchars = max(0, array->length[1][k] - wildcards);
 	    ops.errors = max(characters, genchars);
 	    if (ops.errors > 0)
 	    {
@@ -111,7 +130,7 @@ Synclist *synclist;
 		ops.ins   = max(0, characters - genchars);
 		ops.subst = min(characters, genchars);
 		ops.del   = max(0, genchars - characters);
-		make_key(key, sync);
+		make_key(key, array, k);
 		if (reject_characters + suspect_markers > 0)
 		{
 		    add_ops(&accdata.marked_ops, &ops);
@@ -129,20 +148,91 @@ Synclist *synclist;
 }
 /**********************************************************************/
 
+void report_coverage(text)
+Text *text;
+{
+    fprintf(stderr, "%s: %s cover %ld of %ld characters (%.1f%%)\n",
+    exec_name, (lines ? "identical lines" : "anchors"), fastukk_anchor_coverage,
+    text[0].count, (text[0].count > 0 ? 100.0 * fastukk_anchor_coverage /
+    text[0].count : 100.0));
+}
+/**********************************************************************/
+
+long count_wildcards(text)
+Text *text;
+{
+    long i, wildcards = 0;
+    for (i = 0; i < text->count; i++)
+	if (TEXT_VALUE(text, i) == REJECT_CHARACTER)
+	    wildcards++;
+    return(wildcards);
+}
+/**********************************************************************/
+
+void report_excess()
+{
+    fprintf(stderr,
+    "%s: approximate alignment: at most %ld edits more than optimal\n",
+    exec_name, fastukk_excess);
+}
+/**********************************************************************/
+
 main(argc, argv)
 int argc;
 char *argv[];
 {
-    Synclist synclist;
-    initialize(&argc, argv, usage, NULL);
+    Syncarray array;
+    long maxerrors, wildcards;
+    Boolean synchronized;
+    initialize(&argc, argv, usage, option);
     if (argc < 2 || argc > 3)
 	error("invalid number of files");
+    if (anchored + bit_parallel + lines + diagonal > 1)
+	error("only one of -a, -b, -l and -u may be specified");
+    if (anchored)
+	fastukk_method = SYNC_ANCHORED;
+    if (lines)
+	fastukk_method = SYNC_LINES;
+    if (bit_parallel)
+	fastukk_method = SYNC_BIT_PARALLEL;
+    if (diagonal)
+	fastukk_method = SYNC_DIAGONAL;
+    maxerrors = option_value(maxerrorstring, -1L, 0L, LONG_MAX,
+    "invalid maximum number of errors");
+    if (maxerrors >= 0 && (anchored || bit_parallel || lines))
+	error("-k may not be specified with -a, -b or -l");
+    fastukk_max_cost = option_value(maxcoststring, -1L, 1L, LONG_MAX,
+    "invalid maximum cost");
+    if (fastukk_max_cost >= 0 && (anchored || bit_parallel || lines ||
+    maxerrors >= 0))
+	error("-x may not be specified with -a, -b, -k or -l");
+    fastukk_threads = (short) option_value(threadstring, 1L, 1L,
+    (long) SYNC_MAX_THREADS, "invalid number of threads");
     read_text(&text[0], argv[0], &textopt);
     if (textopt.found_header)
 	error("no correct file specified");
     read_text(&text[1], argv[1], &textopt);
-    fastukk_sync(&synclist, text);
-    process_synclist(&synclist);
+    wildcards = count_wildcards(&text[0]);
+    /* Each reject character in the correct file can match one generated
+     * character as a wildcard without an error, but is an edit to
+     * "fastukk_sync". */
+    if (maxerrors >= 0)
+	fastukk_max_edits = maxerrors + wildcards;
+    synchronized = fastukk_array(&array, text);
+    if (anchored || lines)
+	report_coverage(text);
+    if (fastukk_max_cost >= 0)
+	report_excess();
+    if (synchronized)
+	process_syncarray(&array);
+    if (!synchronized || (maxerrors >= 0 && accdata.errors > maxerrors))
+    {
+	/* The short report cannot be read by accsum, so a batch must not
+	 * take it for a finished one. */
+	write_exceeded_accrpt(text[0].count - wildcards, maxerrors,
+	(argc == 3 ? argv[2] : NULL));
+	terminate_status(EXCEEDED_STATUS);
+    }
     write_accrpt(&accdata, (argc == 3 ? argv[2] : NULL));
     terminate();
 }
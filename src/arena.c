@@ -0,0 +1,274 @@
+/**********************************************************************
+ *
+ *  arena.c
+ *
+ *  Memory for "NEW" and "NEW_ARRAY" is taken from the heap, or from the
+ *  current arena.  An arena takes memory from the heap in aligned chunks
+ *  and hands it out in order.  Objects of each small size have their own
+ *  free list, so that an object released with "DISPOSE" is reused by the
+ *  next "NEW" of its type; other memory is kept until the whole arena is
+ *  freed.
+ *
+ *  The owner of every object is recorded in the memory itself, so that
+ *  "DISPOSE" needs no lock and no search.  An object in a chunk finds it
+ *  at the start of the chunk, by masking its address; every other object,
+ *  whether large or from the heap, has a small header just before it.
+ *  The two kinds are placed at different offsets modulo 32 bytes, which
+ *  tell them apart.
+ *
+ *  Each thread has its own current arena, and an arena is current in one
+ *  thread at a time.  Memory from any arena or the heap may be released
+ *  by any thread, but only the thread in which its arena is current puts
+ *  it on a free list; elsewhere it is just kept until the arena is freed,
+ *  so that the free lists are never touched by two threads at once.
+ *
+ * Copyright 2026 ocreval contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You
+ * may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ **********************************************************************/
+
+#include <pthread.h>
+
+#include "util.h"
+
+/* Every object is aligned to this many bytes; objects in chunks are
+ * aligned to twice as many, and all others are not, so that one bit of an
+ * address tells where its owner is recorded. */
+#define ALIGNMENT  16
+#define SLOT       (2 * ALIGNMENT)
+#define ALIGN(size)  (((size) + SLOT - 1) & ~(size_t) (SLOT - 1))
+#define IN_CHUNK(pointer)  (((size_t) (pointer) & ALIGNMENT) == 0)
+
+/* Objects of up to this many bytes are reused after being disposed. */
+#define MAX_SLAB_SIZE  256
+#define NUM_SLABS      (MAX_SLAB_SIZE / SLOT)
+
+/* Each chunk has this many bytes, and starts at a multiple of it; larger
+ * objects are taken from the heap one by one, so that little of a chunk
+ * is left unused. */
+#define CHUNK_SIZE  65536
+#define MAX_CHUNK_OBJECT  (CHUNK_SIZE / 8)
+
+typedef
+struct chunk
+{
+    struct chunk *next;
+    Arena *arena;           /* the arena that owns the chunk */
+} Chunk;
+
+#define CHUNK_HEADER  ALIGN(sizeof(Chunk))
+
+typedef
+struct block
+{
+    struct block *next;     /* next large object of the same arena */
+    Arena *arena;           /* the arena that owns it, or NULL */
+    void *memory;           /* as taken from the heap */
+} Block;                    /* the header of an object not in a chunk */
+
+/* A block needs this many bytes beyond its object, for its header and
+ * the offset of the object. */
+#define BLOCK_ROOM  (sizeof(Block) + SLOT)
+
+typedef
+struct slab
+{
+    struct slab *next;
+} Slab;                     /* a disposed object on a free list */
+
+struct arena
+{
+    Chunk *chunk;           /* most recent chunk, followed by the others */
+    Block *block;           /* large objects */
+    char *free, *stop;      /* memory left in the most recent chunk */
+    Slab *slab[NUM_SLABS];  /* disposed objects of each size */
+};
+
+/* The current arena of each thread, which is NULL (the heap) until it
+ * calls "use_arena". */
+static pthread_key_t current_key;
+static pthread_once_t key_created = PTHREAD_ONCE_INIT;
+
+/**********************************************************************/
+
+static void *heap_allocate(number, size)
+size_t number, size;
+{
+    void *p;
+    p = calloc(number, size);
+    if (!p)
+	error("unable to allocate memory");
+    return(p);
+}
+/**********************************************************************/
+
+/* Takes an object of "size" bytes from the heap, behind a header naming
+ * "arena" as its owner; a large object of an arena is linked to it. */
+static void *block_allocate(arena, size)
+Arena *arena;
+size_t size;
+{
+    Block *block;
+    char *memory, *p;
+    if (size > (size_t) -1 - BLOCK_ROOM)
+	error("unable to allocate memory");
+    memory = heap_allocate((size_t) 1, size + BLOCK_ROOM);
+    p = memory + sizeof(Block);
+    p += (SLOT + ALIGNMENT - (size_t) p % SLOT) % SLOT;
+    block = (Block *) (p - sizeof(Block));
+    block->arena = arena;
+    block->memory = memory;
+    if (arena)
+    {
+	block->next = arena->block;
+	arena->block = block;
+    }
+    return(p);
+}
+/**********************************************************************/
+
+static void add_chunk(arena)
+Arena *arena;
+{
+    void *memory;
+    Chunk *chunk;
+    if (posix_memalign(&memory, (size_t) CHUNK_SIZE, (size_t) CHUNK_SIZE) != 0)
+	error("unable to allocate memory");
+    chunk = (Chunk *) memory;
+    chunk->next = arena->chunk;
+    chunk->arena = arena;
+    arena->chunk = chunk;
+    arena->free = (char *) chunk + CHUNK_HEADER;
+    arena->stop = (char *) chunk + CHUNK_SIZE;
+}
+/**********************************************************************/
+
+static void *arena_allocate(arena, size)
+Arena *arena;
+size_t size;
+{
+    Slab *slab;
+    char *p;
+    if (size > MAX_CHUNK_OBJECT)
+	return(block_allocate(arena, size));
+    size = (size == 0 ? SLOT : ALIGN(size));
+    if (size <= MAX_SLAB_SIZE && (slab = arena->slab[size / SLOT - 1]))
+    {
+	arena->slab[size / SLOT - 1] = slab->next;
+	memset(slab, 0, size);
+	return(slab);
+    }
+    if (!arena->chunk || size > (size_t) (arena->stop - arena->free))
+	add_chunk(arena);
+    /* Chunks are not cleared when taken from the heap, but as their
+     * memory is handed out. */
+    p = arena->free;
+    arena->free += size;
+    memset(p, 0, size);
+    return(p);
+}
+/**********************************************************************/
+
+static void create_key()
+{
+    if (pthread_key_create(&current_key, NULL) != 0)
+	error("unable to create thread-specific data");
+}
+/**********************************************************************/
+
+static Arena *current_arena()
+{
+    pthread_once(&key_created, create_key);
+    return((Arena *) pthread_getspecific(current_key));
+}
+/**********************************************************************/
+
+void *allocate(number, size)
+size_t number, size;
+{
+    Arena *current = current_arena();
+    if (size > 0 && number > (size_t) -1 / size)
+	error("unable to allocate memory");
+    if (!current)
+	return(block_allocate((Arena *) NULL, number * size));
+    return(arena_allocate(current, number * size));
+}
+/**********************************************************************/
+
+void deallocate(pointer, size)
+void *pointer;
+size_t size;
+{
+    Block *block;
+    Chunk *chunk;
+    Arena *arena;
+    Slab *slab;
+    if (!pointer)
+	return;
+    if (!IN_CHUNK(pointer))
+    {
+	/* A large object of an arena is kept until the arena is freed. */
+	block = (Block *) ((char *) pointer - sizeof(Block));
+	if (!block->arena)
+	    free(block->memory);
+	return;
+    }
+    chunk = (Chunk *) ((char *) pointer - (size_t) pointer % CHUNK_SIZE);
+    arena = chunk->arena;
+    size = (size == 0 ? 0 : ALIGN(size));
+    if (size > 0 && size <= MAX_SLAB_SIZE && arena == current_arena())
+    {
+	slab = (Slab *) pointer;
+	slab->next = arena->slab[size / SLOT - 1];
+	arena->slab[size / SLOT - 1] = slab;
+    }
+}
+/**********************************************************************/
+
+Arena *new_arena()
+{
+    return((Arena *) heap_allocate((size_t) 1, sizeof(Arena)));
+}
+/**********************************************************************/
+
+Arena *use_arena(arena)
+Arena *arena;
+{
+    Arena *previous = current_arena();
+    pthread_setspecific(current_key, arena);
+    return(previous);
+}
+/**********************************************************************/
+
+void free_arena(arena)
+Arena *arena;
+{
+    Chunk *chunk;
+    Block *block;
+    if (current_arena() == arena)
+	pthread_setspecific(current_key, NULL);
+    while (arena->chunk)
+    {
+	chunk = arena->chunk;
+	arena->chunk = chunk->next;
+	free(chunk);
+    }
+    while (arena->block)
+    {
+	block = arena->block;
+	arena->block = block->next;
+	free(block->memory);
+    }
+    free(arena);
+}
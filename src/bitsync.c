@@ -0,0 +1,471 @@
+/**********************************************************************
+ *
+ *  bitsync.c
+ *
+ * Copyright 2026 ocreval contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You
+ * may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ **********************************************************************/
+
+#include <math.h>
+#include <stdint.h>
+
+#include "bitsync.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define X86_SIMD
+#include <immintrin.h>
+#define TARGET(isa)  __attribute__ ((target (isa)))
+#endif
+
+#ifdef __GNUC__
+#define POPCOUNT(word)  __builtin_popcountll(word)
+#else
+#define POPCOUNT(word)  popcount(word)
+#endif
+
+typedef uint64_t Bitvector;
+
+#define BLOCK_BITS   64
+#define BLOCK_SHIFT  6
+#define ALL_ONES     (~(Bitvector) 0)
+
+/* Blocks are advanced in groups of this many. */
+#define GROUP_SIZE   4
+#define GROUP_SHIFT  2
+
+/* Adjacent character pairs are hashed into this many buckets. */
+#define PAIR_BUCKETS  4096
+
+/* Row i of the matrix is character i - 1 of the first text, and column j
+ * is character j - 1 of the second.  Block "block" holds rows
+ * 64 block + 1 through 64 block + 64; "stride" is the number of blocks
+ * rounded up to a whole number of groups. */
+typedef
+struct
+{
+    long m, n, blocks, stride;
+    Bitvector *peq;     /* for each distinct character of the first text,
+                           followed by a character that does not occur in
+                           it, "stride" masks of the rows holding the
+                           character */
+    long *column;       /* offset in "peq" of the masks of the character of
+                           each column; the three entries before and after
+                           the columns hold that of the missing character */
+
+    /* For each column j >= 1 and block, at index CELL(j, block): */
+    Bitvector *pv, *mv; /* rows of the block at which the distance
+                           increases, or decreases, from the row above */
+    int32_t *score;     /* distance at the last row of the block */
+} Matrix;               /* the state of one alignment, so that several may
+                           be computed at once by different threads */
+
+/* The cells of each group of blocks are stored along the anti-diagonals
+ * of the group, in which block "first" + l is at column t - l + 1 for
+ * step t, so that a group stores one vector per step. */
+#define CELL(j, block)  \
+    ((((block) >> GROUP_SHIFT) * (matrix->n + GROUP_SIZE - 1) + (j) - 1 + \
+    ((block) & (GROUP_SIZE - 1))) * GROUP_SIZE + \
+    ((block) & (GROUP_SIZE - 1)))
+
+/**********************************************************************/
+
+#ifndef __GNUC__
+
+static int popcount(word)
+Bitvector word;
+{
+    int count = 0;
+    for (; word; word &= word - 1)
+	count++;
+    return(count);
+}
+
+#endif
+/**********************************************************************/
+
+static unsigned long hash_pair(text, i)
+Text *text;
+long i;
+{
+    return((TEXT_VALUE(text, i) * 31 + TEXT_VALUE(text, i + 1)) * 2654435761UL
+    % PAIR_BUCKETS);
+}
+/**********************************************************************/
+
+long estimate_distance(text)
+Text *text;
+{
+    long *count, i, difference = 0;
+    count = NEW_ARRAY(PAIR_BUCKETS, long);
+    for (i = 0; i + 1 < text[0].count; i++)
+	count[hash_pair(&text[0], i)]++;
+    for (i = 0; i + 1 < text[1].count; i++)
+	count[hash_pair(&text[1], i)]--;
+    for (i = 0; i < PAIR_BUCKETS; i++)
+	difference += labs(count[i]);
+    DISPOSE_ARRAY(count);
+    /* Each edit changes the profiles by at most four pairs. */
+    return(max(labs(text[1].count - text[0].count), (difference + 3) / 4));
+}
+/**********************************************************************/
+
+double bit_parallel_size(text)
+Text *text;
+{
+    double rows = text[0].count, columns = text[1].count, characters;
+    characters = (text[0].width == 1 ? min(rows, 256) : rows) + 1;
+    return(ceil(rows / BLOCK_BITS) * (columns * (2 * sizeof(Bitvector) +
+    sizeof(int32_t)) + characters * sizeof(Bitvector)) +
+    (rows + columns) * sizeof(long));
+}
+/**********************************************************************/
+
+static long find_character(key, index, size, value, insert)
+Charvalue *key;
+long *index, size, *insert;
+Charvalue value;
+{
+    long h;
+    for (h = (value * 2654435761UL) & (size - 1); index[h];
+    h = (h + 1) & (size - 1))
+	if (key[h] == value)
+	    return(index[h] - 1);
+    if (!insert)
+	return(-1);
+    key[h] = value;
+    index[h] = ++*insert;
+    return(index[h] - 1);
+}
+/**********************************************************************/
+
+static void build_peq(matrix, text)
+Matrix *matrix;
+Text *text;
+{
+    Charvalue *key, value;
+    long m = matrix->m, n = matrix->n, stride = matrix->stride;
+    long *index, size, *row, sigma = 0, i, c, *column;
+    Bitvector *peq;
+    for (size = 2; size < 2 * m + 2; size <<= 1);
+    key = NEW_ARRAY(size, Charvalue);
+    index = NEW_ARRAY(size, long);
+    row = NEW_ARRAY(m, long);
+    for (i = 0; i < m; i++)
+    {
+	value = TEXT_VALUE(&text[0], i);
+	row[i] = (value == REJECT_CHARACTER ? -1 :
+	find_character(key, index, size, value, &sigma));
+    }
+    /* Rejected characters never match, so they get the masks of the
+     * missing character, which are all clear. */
+    peq = matrix->peq = NEW_ARRAY((sigma + 1) * stride, Bitvector);
+    for (i = 0; i < m; i++)
+	if (row[i] >= 0)
+	    peq[row[i] * stride + (i >> BLOCK_SHIFT)] |=
+	    (Bitvector) 1 << (i & (BLOCK_BITS - 1));
+    column = matrix->column = NEW_ARRAY(n + 2 * (GROUP_SIZE - 1), long) +
+    GROUP_SIZE - 1;
+    for (i = -(GROUP_SIZE - 1); i < n + GROUP_SIZE - 1; i++)
+    {
+	value = (i >= 0 && i < n ? TEXT_VALUE(&text[1], i) : REJECT_CHARACTER);
+	c = (value == REJECT_CHARACTER ? -1 :
+	find_character(key, index, size, value, NULL));
+	column[i] = (c < 0 ? sigma : c) * stride;
+    }
+    DISPOSE_ARRAY(row);
+    DISPOSE_ARRAY(index);
+    DISPOSE_ARRAY(key);
+}
+/**********************************************************************/
+
+/* Bit of the last row of the given block. */
+#define HIGH_BIT(block)  \
+    ((block) == matrix->blocks - 1 ? (matrix->m - 1) & (BLOCK_BITS - 1) : \
+    BLOCK_BITS - 1)
+
+static void compute_columns(matrix)
+Matrix *matrix;
+{
+    Bitvector vp, vm, eq, xv, xh, ph, mh;
+    Bitvector *peq = matrix->peq, *pv = matrix->pv, *mv = matrix->mv;
+    int32_t *score = matrix->score;
+    long m = matrix->m, n = matrix->n, blocks = matrix->blocks;
+    long *column = matrix->column, j, block, cell, prev, bit;
+    int32_t sc;
+    int hin, hout;
+    for (j = 1; j <= n; j++)
+    {
+	hin = 1;
+	for (block = 0; block < blocks; block++)
+	{
+	    cell = CELL(j, block);
+	    if (j == 1)
+	    {
+		vp = ALL_ONES;
+		vm = 0;
+		sc = min((block + 1) << BLOCK_SHIFT, m);
+	    }
+	    else
+	    {
+		prev = CELL(j - 1, block);
+		vp = pv[prev];
+		vm = mv[prev];
+		sc = score[prev];
+	    }
+	    eq = peq[column[j - 1] + block];
+	    bit = HIGH_BIT(block);
+	    xv = eq | vm;
+	    if (hin < 0)
+		eq |= 1;
+	    xh = (((eq & vp) + vp) ^ vp) | eq;
+	    ph = vm | ~(xh | vp);
+	    mh = vp & xh;
+	    hout = (int) ((ph >> bit) & 1) - (int) ((mh >> bit) & 1);
+	    ph <<= 1;
+	    mh <<= 1;
+	    if (hin < 0)
+		mh |= 1;
+	    else if (hin > 0)
+		ph |= 1;
+	    pv[cell] = mh | ~(xv | ph);
+	    mv[cell] = ph & xv;
+	    score[cell] = sc + hout;
+	    hin = hout;
+	}
+    }
+}
+/**********************************************************************/
+
+#ifdef X86_SIMD
+
+/* Advances the group of blocks beginning with "first" along its
+ * anti-diagonals, so that the horizontal difference leaving each block
+ * at one step enters the next block at the following step.  "carry"
+ * holds the difference entering the group at each column, and receives
+ * the difference leaving it.  Lanes outside the matrix are harmless:
+ * before the first column they see no match and no difference, which
+ * leaves the initial state unchanged, and after the last they are never
+ * read. */
+TARGET("avx2")
+static void compute_group(matrix, first, carry)
+Matrix *matrix;
+long first;
+signed char *carry;
+{
+    __m256i vp, vm, sc, hp, hm, eq, xv, xh, ph, mh, op, om, bit, one, ones;
+    __m256i offset, reverse, pack;
+    Bitvector *group_vp, *group_vm;
+    int32_t *group_score;
+    long m = matrix->m, n = matrix->n, blocks = matrix->blocks;
+    long *column = matrix->column, t, l, block, cell;
+    int64_t lane_sc[GROUP_SIZE], lane_bit[GROUP_SIZE];
+    one = _mm256_set1_epi64x(1);
+    ones = _mm256_set1_epi64x(-1);
+    for (l = 0; l < GROUP_SIZE; l++)
+    {
+	block = min(first + l, blocks - 1);
+	lane_sc[l] = min((first + l + 1) << BLOCK_SHIFT, m);
+	lane_bit[l] = HIGH_BIT(block);
+    }
+    sc = _mm256_loadu_si256((__m256i *) lane_sc);
+    bit = _mm256_loadu_si256((__m256i *) lane_bit);
+    offset = _mm256_set_epi64x(first + 3, first + 2, first + 1, first);
+    reverse = _mm256_set_epi32(1, 0, 3, 2, 5, 4, 7, 6);
+    pack = _mm256_set_epi32(7, 5, 3, 1, 6, 4, 2, 0);
+    vp = ones;
+    vm = hp = hm = _mm256_setzero_si256();
+    cell = CELL(1, first);
+    group_vp = matrix->pv + cell;
+    group_vm = matrix->mv + cell;
+    group_score = matrix->score + cell;
+    for (t = 0; t < n + GROUP_SIZE - 1; t++)
+    {
+	/* Lane l takes the character of column t - l + 1. */
+	eq = _mm256_i64gather_epi64((const void *) matrix->peq,
+	_mm256_add_epi64(_mm256_permutevar8x32_epi32(_mm256_loadu_si256(
+	(__m256i *) (column + t - (GROUP_SIZE - 1))), reverse), offset), 8);
+	hp = _mm256_blend_epi32(hp, _mm256_set1_epi64x(carry[t] > 0), 0x03);
+	hm = _mm256_blend_epi32(hm, _mm256_set1_epi64x(carry[t] < 0), 0x03);
+
+	xv = _mm256_or_si256(eq, vm);
+	eq = _mm256_or_si256(eq, hm);
+	xh = _mm256_or_si256(_mm256_xor_si256(_mm256_add_epi64(
+	_mm256_and_si256(eq, vp), vp), vp), eq);
+	ph = _mm256_or_si256(vm, _mm256_xor_si256(_mm256_or_si256(xh, vp),
+	ones));
+	mh = _mm256_and_si256(vp, xh);
+	op = _mm256_and_si256(_mm256_srlv_epi64(ph, bit), one);
+	om = _mm256_and_si256(_mm256_srlv_epi64(mh, bit), one);
+	ph = _mm256_or_si256(_mm256_slli_epi64(ph, 1), hp);
+	mh = _mm256_or_si256(_mm256_slli_epi64(mh, 1), hm);
+	vp = _mm256_or_si256(mh, _mm256_xor_si256(_mm256_or_si256(xv, ph),
+	ones));
+	vm = _mm256_and_si256(ph, xv);
+	sc = _mm256_add_epi64(sc, _mm256_sub_epi64(op, om));
+
+	_mm256_storeu_si256((__m256i *) (group_vp + t * GROUP_SIZE), vp);
+	_mm256_storeu_si256((__m256i *) (group_vm + t * GROUP_SIZE), vm);
+	_mm_storeu_si128((__m128i *) (group_score + t * GROUP_SIZE),
+	_mm256_castsi256_si128(_mm256_permutevar8x32_epi32(sc, pack)));
+	if (t >= GROUP_SIZE - 1)
+	    carry[t - (GROUP_SIZE - 1)] = (signed char)
+	    _mm256_extract_epi64(_mm256_sub_epi64(op, om), 3);
+	/* Each block passes its difference to the next one. */
+	hp = _mm256_permute4x64_epi64(op, 0x90);
+	hm = _mm256_permute4x64_epi64(om, 0x90);
+    }
+}
+/**********************************************************************/
+
+static void compute_columns_avx2(matrix)
+Matrix *matrix;
+{
+    signed char *carry;
+    long n = matrix->n, first;
+    /* The first group takes its differences from the top row of the
+     * matrix. */
+    carry = NEW_ARRAY(n + GROUP_SIZE - 1, signed char);
+    memset(carry, 1, n);
+    for (first = 0; first < matrix->blocks; first += GROUP_SIZE)
+	compute_group(matrix, first, carry);
+    DISPOSE_ARRAY(carry);
+}
+
+#endif
+/**********************************************************************/
+
+/* Returns the edit distance between the first i characters of the first
+ * text and the first j characters of the second. */
+static long distance(matrix, i, j)
+Matrix *matrix;
+long i, j;
+{
+    long block, cell, bit;
+    Bitvector mask;
+    if (i == 0)
+	return(j);
+    if (j == 0)
+	return(i);
+    block = (i - 1) >> BLOCK_SHIFT;
+    bit = (i - 1) & (BLOCK_BITS - 1);
+    cell = CELL(j, block);
+    mask = (bit == BLOCK_BITS - 1 ? ALL_ONES :
+    ((Bitvector) 1 << (bit + 1)) - 1);
+    return((block == 0 ? j : matrix->score[CELL(j, block - 1)]) +
+    POPCOUNT(matrix->pv[cell] & mask) - POPCOUNT(matrix->mv[cell] & mask));
+}
+/**********************************************************************/
+
+/* Returns the furthest row of diagonal k whose distance does not exceed p,
+ * or -1 if there is none.  Distances never decrease along a diagonal. */
+static long furthest(matrix, k, p)
+Matrix *matrix;
+long k, p;
+{
+    long low, high, middle;
+    low = max(0, -k);
+    high = min(matrix->m, matrix->n - k);
+    if (low > high || distance(matrix, low, low + k) > p)
+	return(-1);
+    while (low < high)
+    {
+	middle = (low + high + 1) >> 1;
+	if (distance(matrix, middle, middle + k) <= p)
+	    low = middle;
+	else
+	    high = middle - 1;
+    }
+    return(low);
+}
+/**********************************************************************/
+
+/* Follows the alignment back from the last cell, taking the furthest row
+ * of each diagonal reached with each number of edits.  Ties are broken
+ * as "initial_f" of sync.c breaks them; since Ukkonen's algorithm prunes
+ * only diagonals that lie on no optimal alignment, it chooses the same
+ * predecessor at every step. */
+static void trace_back(matrix, found, data)
+Matrix *matrix;
+void (*found)();
+void *data;
+{
+    long m = matrix->m, n = matrix->n, k, p, f, start, prev_k, prev_f, d;
+    long value;
+    k = n - m;
+    f = m;
+    for (p = distance(matrix, m, n); p >= 0; p--)
+    {
+	start = prev_k = prev_f = 0;
+	if (p > 0)
+	{
+	    start = -1;
+	    for (d = k - 1; d <= k + 1; d++)
+	    {
+		value = furthest(matrix, d, p - 1);
+		if (value < 0 || value + (d >= k) > min(m, n - k))
+		    continue;
+		if (value + (d >= k) >= start)
+		{
+		    start = value + (d >= k);
+		    prev_k = d;
+		    prev_f = value;
+		}
+	    }
+	    if (start < 0)
+		error("internal synchronization error");
+	}
+	if (f > start)
+	    (*found)(data, start, start + k, f - start);
+	k = prev_k;
+	f = prev_f;
+    }
+}
+/**********************************************************************/
+
+void bit_parallel_sync(text, found, data)
+Text *text;
+void (*found)();
+void *data;
+{
+    Matrix matrix;
+    long cells;
+    matrix.m = text[0].count;
+    matrix.n = text[1].count;
+    if (matrix.m == 0 || matrix.n == 0)
+	return;
+    if (max(matrix.m, matrix.n) > INT32_MAX)
+	error("text stream is too long");
+    matrix.blocks = (matrix.m + BLOCK_BITS - 1) >> BLOCK_SHIFT;
+    matrix.stride = (matrix.blocks + GROUP_SIZE - 1) &
+    ~(long) (GROUP_SIZE - 1);
+    build_peq(&matrix, text);
+    cells = matrix.stride * (matrix.n + GROUP_SIZE - 1);
+    matrix.pv = NEW_ARRAY(cells, Bitvector);
+    matrix.mv = NEW_ARRAY(cells, Bitvector);
+    matrix.score = NEW_ARRAY(cells, int32_t);
+#ifdef X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+	compute_columns_avx2(&matrix);
+    else
+#endif
+	compute_columns(&matrix);
+    trace_back(&matrix, found, data);
+    DISPOSE_ARRAY(matrix.score);
+    DISPOSE_ARRAY(matrix.mv);
+    DISPOSE_ARRAY(matrix.pv);
+    DISPOSE_ARRAY(matrix.column - (GROUP_SIZE - 1));
+    DISPOSE_ARRAY(matrix.peq);
+}
@@ -0,0 +1,62 @@
+/**********************************************************************
+ *
+ *  bitsync.h
+ *
+ *  This module aligns two texts optimally with the bit-parallel
+ *  algorithm of Myers, as extended to blocks of rows by Hyyro.  Each
+ *  column of the edit distance matrix is computed 64 rows at a time,
+ *  as the vertical differences between adjacent cells packed into the
+ *  bits of two words, so the work is proportional to m n / 64 whatever
+ *  the distance.  This makes it faster than Ukkonen's algorithm when the
+ *  texts are very different.
+ *
+ *  The characters of the first text are numbered in order of first
+ *  appearance, and a bit mask of their positions is built for each
+ *  distinct character only.  With AVX2, four blocks are advanced at once
+ *  along an anti-diagonal of the matrix.
+ *
+ *  The texts must have the same width.
+ *
+ * Copyright 2026 ocreval contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You
+ * may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ **********************************************************************/
+
+#ifndef _BITSYNC_
+#define _BITSYNC_
+
+#include "text.h"
+
+long estimate_distance(/* Text *text */);
+			/* returns a lower bound on the edit distance between
+			   the two texts in the array "text", from the
+			   difference between their profiles of adjacent
+			   character pairs; it is quick to compute but may
+			   be far below the distance */
+
+double bit_parallel_size(/* Text *text */);
+			/* returns the number of bytes of memory that
+			   "bit_parallel_sync" needs for the two texts in the
+			   array "text" */
+
+void bit_parallel_sync(/* Text *text,
+			  void (*found)(void *data, long start1, long start2,
+			  long length), void *data */);
+			/* aligns the two texts in the array "text" optimally
+			   and calls "found" with "data" for each matched
+			   substring of the alignment, from last to first; the
+			   alignment chosen is the one chosen by Ukkonen's
+			   algorithm in "fastukk_sync" */
+
+#endif
@@ -67,10 +67,10 @@ Synclist *synclist;
 Sync *sync;
 {
     list_remove(synclist, sync);
-    free(sync->substr);
+    DISPOSE_ARRAY(sync->substr);
     if (sync->match)
-	free(sync->match);
-    free(sync);
+	DISPOSE(sync->match, long);
+    DISPOSE(sync, Sync);
 }
 /**********************************************************************/
 
@@ -83,7 +83,7 @@ Text *text;
     for (sync = synclist->first; sync; sync = sync->next)
 	if (!sync->match)
 	    for (i = sync->substr->start; i <= sync->substr->stop; i++)
-		if (text->array[i]->value != REJECT_CHARACTER)
+		if (TEXT_VALUE(text, i) != REJECT_CHARACTER)
 		    edodata.total_insertions++;
 }
 /**********************************************************************/
@@ -218,7 +218,7 @@ Synclist *synclist;
 	candidate = find_candidates(synclist);
 	sync = find_move(synclist, candidate);
 	perform_move(synclist, candidate, sync);
-	free(candidate);
+	DISPOSE_ARRAY(candidate);
 	combine_adjacent(synclist);
     }
 }
@@ -23,6 +23,7 @@
  **********************************************************************/
 
 #include "edorpt.h"
+#include "output.h"
 #include "util.h"
 #include "ocreval_version.h"
 
@@ -34,14 +35,14 @@ static char line[100];
 /**********************************************************************/
 
 static Boolean read_line(f)
-FILE *f;
+gzFile f;
 {
-    return(fgets(line, sizeof(line) - 1, f) ? True : False);
+    return(gzgets(f, line, sizeof(line) - 1) ? True : False);
 }
 /**********************************************************************/
 
 static Boolean read_value(f, value, sum_value)
-FILE *f;
+gzFile f;
 long *value, *sum_value;
 {
     if (read_line(f) && sscanf(line, "%ld", value) == 1)
@@ -55,7 +56,7 @@ long *value, *sum_value;
 /**********************************************************************/
 
 static Boolean read_two(f, value1, value2)
-FILE *f;
+gzFile f;
 long *value1, *value2;
 {
     return(read_line(f) && sscanf(line, "%ld %ld", value1, value2) == 2 ?
@@ -67,9 +68,9 @@ void read_edorpt(edodata, filename)
 Edodata *edodata;
 char *filename;
 {
-    FILE *f;
+    gzFile f;
     long moves, value1, value2;
-    f = open_file(filename, "r");
+    f = open_gzfile(filename);
     if (read_line(f) && strncmp(line, TITLE, sizeof(TITLE) - 3) == 0 &&
     read_line(f) && strcmp(line, DIVIDER) == 0 &&
     read_value(f, &value1, &edodata->total_insertions) &&
@@ -82,24 +83,30 @@ char *filename;
     }
     else
 	error_string("invalid format in", (filename ? filename : "stdin"));
-    close_file(f);
+    close_gzfile(f);
 }
 /**********************************************************************/
 
-static void write_value(f, value, string)
-FILE *f;
+static void write_value(output, value, string)
+Output *output;
 long value;
 char *string;
 {
-    fprintf(f, "%8ld   %s\n", value, string);
+    output_long(output, value, 8);
+    output_string(output, "   ");
+    output_string(output, string);
+    OUTPUT_BYTE(output, '\n');
 }
 /**********************************************************************/
 
-static void write_move(f, count, length)
-FILE *f;
+static void write_move(output, count, length)
+Output *output;
 long count, length;
 {
-    fprintf(f, "%8ld %8ld\n", count, length);
+    output_long(output, count, 8);
+    OUTPUT_BYTE(output, ' ');
+    output_long(output, length, 8);
+    OUTPUT_BYTE(output, '\n');
 }
 /**********************************************************************/
 
@@ -107,19 +114,20 @@ void write_edorpt(edodata, filename)
 Edodata *edodata;
 char *filename;
 {
-    FILE *f;
+    Output output;
     long i;
-    f = open_file(filename, "w");
-    fprintf(f, "%s%s", TITLE, DIVIDER);
-    write_value(f, edodata->total_insertions, "Insertions");
-    write_value(f, edodata->total_deletions, "Deletions");
-    write_value(f, edodata->total_moves, "Moves");
+    open_output(&output, filename);
+    output_string(&output, TITLE);
+    output_string(&output, DIVIDER);
+    write_value(&output, edodata->total_insertions, "Insertions");
+    write_value(&output, edodata->total_deletions, "Deletions");
+    write_value(&output, edodata->total_moves, "Moves");
     if (edodata->total_moves > 0)
     {
-	fprintf(f, "\nMoves\n   Count   Length\n");
+	output_string(&output, "\nMoves\n   Count   Length\n");
 	for (i = 1; i <= MAX_MOVE_LENGTH; i++)
 	    if (edodata->moves[i] > 0)
-		write_move(f, edodata->moves[i], i);
+		write_move(&output, edodata->moves[i], i);
     }
-    close_file(f);
+    close_output(&output);
 }
@@ -47,10 +47,11 @@ struct
 } Edodata;
 
 void read_edorpt(/* Edodata *edodata, char *filename */);
-			/* reads the named file (or stdin if "filename" is NULL)
-			   and adds its contents to "edodata"; reports an error
-			   and quits if unable to open the file, or if the file
-			   does not contain an edit operation report */
+			/* reads the named file (or stdin if "filename" is NULL),
+			   which may be gzip-compressed, and adds its contents
+			   to "edodata"; reports an error and quits if unable to
+			   open the file, or if the file does not contain
+			   an edit operation report */
 
 void write_edorpt(/* Edodata *edodata, char *filename */);
 			/* writes the contents of "edodata" to the named file
@@ -23,6 +23,7 @@
  **********************************************************************/
 
 #include "accrpt.h"
+#include "output.h"
 
 #define usage  "groupfile accuracy_report [groupacc_report]"
 
@@ -34,42 +35,49 @@ Accdata accdata;
 
 /**********************************************************************/
 
-void write_line(f, count, missed)
-FILE *f;
+void write_line(output, count, missed)
+Output *output;
 long count, missed;
 {
-    fprintf(f, "%8ld %8ld ", count, missed);
+    output_long(output, count, 8);
+    OUTPUT_BYTE(output, ' ');
+    output_long(output, missed, 8);
+    OUTPUT_BYTE(output, ' ');
     if (count == 0)
-	fprintf(f, "  ------   ");
+	output_string(output, "  ------");
     else
-	fprintf(f, "%8.2f   ", 100.0 * (count - missed) / count);
+	output_fixed(output, 100.0 * (count - missed) / count, 8, 2);
+    output_string(output, "   ");
 }
 /**********************************************************************/
 
 void write_report(filename)
 char *filename;
 {
-    FILE *f;
-    long total_count = 0, total_missed = 0, count, missed;
-    Char *c;
-    char buffer[STRING_SIZE];
-    f = open_file(filename, "w");
-    fprintf(f, "   Count   Missed   %%Right\n");
-    for (c = text.first; c; c = c->next)
-	if (accdata.small_class[c->value].count > 0 && c->value != BLANK &&
-	c->value != NEWLINE)
+    Output output;
+    long total_count = 0, total_missed = 0, count, missed, i;
+    Charvalue value;
+    open_output(&output, filename);
+    output_string(&output, "   Count   Missed   %Right\n");
+    for (i = 0; i < text.count; i++)
+    {
+	value = TEXT_VALUE(&text, i);
+	if (accdata.small_class[value].count > 0 && value != BLANK &&
+	value != NEWLINE)
 	{
-	    count  = accdata.small_class[c->value].count;
-	    missed = accdata.small_class[c->value].missed;
-	    write_line(f, count, missed);
-	    char_to_string(False, c->value, buffer, True);
-	    fprintf(f, "{%s}\n", buffer);
+	    count  = accdata.small_class[value].count;
+	    missed = accdata.small_class[value].missed;
+	    write_line(&output, count, missed);
+	    OUTPUT_BYTE(&output, '{');
+	    output_char(&output, False, value, True);
+	    output_string(&output, "}\n");
 	    total_count  += count;
 	    total_missed += missed;
 	}
-    write_line(f, total_count, total_missed);
-    fprintf(f, "Total\n");
-    close_file(f);
+    }
+    write_line(&output, total_count, total_missed);
+    output_string(&output, "Total\n");
+    close_output(&output);
 }
 /**********************************************************************/
 
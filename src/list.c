@@ -47,7 +47,7 @@ List *list;
 {
     if (list->array)
     {
-	free(list->array);
+	DISPOSE_ARRAY(list->array);
 	list->array = NULL;
     }
 }
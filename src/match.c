@@ -0,0 +1,96 @@
+/**********************************************************************
+ *
+ *  match.c
+ *
+ * Copyright 2026 ocreval contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You
+ * may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ **********************************************************************/
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include "match.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define X86_SIMD
+#include <immintrin.h>
+#define TARGET(isa)  __attribute__ ((target (isa)))
+#endif
+
+#define KERNEL_NAME(name)  name ## _1
+#define KERNEL_TYPE        uint8_t
+#define KERNEL_SHIFT       0
+#define KERNEL_SSE2_SET1   _mm_set1_epi8
+#define KERNEL_SSE2_CMPEQ  _mm_cmpeq_epi8
+#define KERNEL_AVX2_SET1   _mm256_set1_epi8
+#define KERNEL_AVX2_CMPEQ  _mm256_cmpeq_epi8
+#include "matchkernel.h"
+
+#define KERNEL_NAME(name)  name ## _2
+#define KERNEL_TYPE        uint16_t
+#define KERNEL_SHIFT       1
+#define KERNEL_SSE2_SET1   _mm_set1_epi16
+#define KERNEL_SSE2_CMPEQ  _mm_cmpeq_epi16
+#define KERNEL_AVX2_SET1   _mm256_set1_epi16
+#define KERNEL_AVX2_CMPEQ  _mm256_cmpeq_epi16
+#include "matchkernel.h"
+
+#define KERNEL_NAME(name)  name ## _4
+#define KERNEL_TYPE        Charvalue
+#define KERNEL_SHIFT       2
+#define KERNEL_SSE2_SET1   _mm_set1_epi32
+#define KERNEL_SSE2_CMPEQ  _mm_cmpeq_epi32
+#define KERNEL_AVX2_SET1   _mm256_set1_epi32
+#define KERNEL_AVX2_CMPEQ  _mm256_cmpeq_epi32
+#include "matchkernel.h"
+
+static pthread_once_t initialized = PTHREAD_ONCE_INIT;
+/* Matchers for values of width 1, 2 and 4, indexed by width / 2. */
+static long (*matcher[3])();
+
+/**********************************************************************/
+
+static void initialize_matcher()
+{
+    matcher[0] = match_scalar_1;
+    matcher[1] = match_scalar_2;
+    matcher[2] = match_scalar_4;
+#ifdef X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2"))
+    {
+	matcher[0] = match_sse2_1;
+	matcher[1] = match_sse2_2;
+	matcher[2] = match_sse2_4;
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+	matcher[0] = match_avx2_1;
+	matcher[1] = match_avx2_2;
+	matcher[2] = match_avx2_4;
+    }
+#endif
+}
+/**********************************************************************/
+
+long match_length(width, value1, value2, length, stop)
+short width;
+void *value1, *value2;
+long length;
+Charvalue stop;
+{
+    pthread_once(&initialized, initialize_matcher);
+    return((*matcher[width >> 1])(value1, value2, length, stop));
+}
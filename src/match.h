@@ -0,0 +1,42 @@
+/**********************************************************************
+ *
+ *  match.h
+ *
+ *  This module measures how far two arrays of character values agree,
+ *  which is the innermost loop of text synchronization: following a
+ *  "snake" along a diagonal of the edit distance matrix, or extending a
+ *  common substring.  Where SSE2 or AVX2 is available, 16 or 32 bytes of
+ *  each array are compared at once, so that 4 to 32 characters are
+ *  examined per comparison depending on their width.
+ *
+ * Copyright 2026 ocreval contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You
+ * may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ **********************************************************************/
+
+#ifndef _MATCH_
+#define _MATCH_
+
+#include "text.h"
+
+long match_length(/* short width, void *value1, void *value2, long length,
+		     Charvalue stop */);
+			/* given two arrays of character values of the given
+			   width (1, 2 or 4 bytes), returns the number of
+			   leading positions, up to "length", at which they
+			   hold equal values other than "stop"; texts pass
+			   REJECT_CHARACTER as "stop", since a reject
+			   character matches nothing */
+
+#endif
@@ -0,0 +1,105 @@
+/**********************************************************************
+ *
+ *  matchkernel.h
+ *
+ *  This file is a template for the comparison loops of match.c.  It is
+ *  included by match.c once for each character width, with these macros
+ *  defined:
+ *
+ *      KERNEL_NAME(name)  name of a function specialized for the width
+ *      KERNEL_TYPE        type of a character value of the width
+ *      KERNEL_SHIFT       log2 of the width in bytes
+ *      KERNEL_SSE2_SET1   SSE2 intrinsic broadcasting a value
+ *      KERNEL_SSE2_CMPEQ  SSE2 intrinsic comparing values for equality
+ *      KERNEL_AVX2_SET1   AVX2 intrinsic broadcasting a value
+ *      KERNEL_AVX2_CMPEQ  AVX2 intrinsic comparing values for equality
+ *
+ *  The macros are undefined again at the end of this file.
+ *
+ * Copyright 2026 ocreval contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You
+ * may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ **********************************************************************/
+
+static long KERNEL_NAME(match_scalar)(c1, c2, length, stop)
+KERNEL_TYPE *c1, *c2;
+long length;
+Charvalue stop;
+{
+    long i;
+    for (i = 0; i < length && c1[i] == c2[i] && c1[i] != stop; i++);
+    return(i);
+}
+/**********************************************************************/
+
+#ifdef X86_SIMD
+
+/* A block agrees at each byte whose value equals that of the other array
+ * and differs from "stop"; the first byte that does not gives the first
+ * character that does not. */
+TARGET("sse2")
+static long KERNEL_NAME(match_sse2)(c1, c2, length, stop)
+KERNEL_TYPE *c1, *c2;
+long length;
+Charvalue stop;
+{
+    long i;
+    unsigned int agree;
+    __m128i block, stops;
+    stops = KERNEL_SSE2_SET1((KERNEL_TYPE) stop);
+    for (i = 0; i + (16 >> KERNEL_SHIFT) <= length; i += 16 >> KERNEL_SHIFT)
+    {
+	block = _mm_loadu_si128((__m128i *) &c1[i]);
+	agree = (unsigned int) _mm_movemask_epi8(_mm_andnot_si128(
+	KERNEL_SSE2_CMPEQ(block, stops), KERNEL_SSE2_CMPEQ(block,
+	_mm_loadu_si128((__m128i *) &c2[i]))));
+	if (agree != 0xFFFF)
+	    return(i + (__builtin_ctz(~agree) >> KERNEL_SHIFT));
+    }
+    return(i + KERNEL_NAME(match_scalar)(&c1[i], &c2[i], length - i, stop));
+}
+/**********************************************************************/
+
+TARGET("avx2")
+static long KERNEL_NAME(match_avx2)(c1, c2, length, stop)
+KERNEL_TYPE *c1, *c2;
+long length;
+Charvalue stop;
+{
+    long i;
+    unsigned int agree;
+    __m256i block, stops;
+    stops = KERNEL_AVX2_SET1((KERNEL_TYPE) stop);
+    for (i = 0; i + (32 >> KERNEL_SHIFT) <= length; i += 32 >> KERNEL_SHIFT)
+    {
+	block = _mm256_loadu_si256((__m256i *) &c1[i]);
+	agree = (unsigned int) _mm256_movemask_epi8(_mm256_andnot_si256(
+	KERNEL_AVX2_CMPEQ(block, stops), KERNEL_AVX2_CMPEQ(block,
+	_mm256_loadu_si256((__m256i *) &c2[i]))));
+	if (agree != 0xFFFFFFFF)
+	    return(i + (__builtin_ctz(~agree) >> KERNEL_SHIFT));
+    }
+    return(i + KERNEL_NAME(match_sse2)(&c1[i], &c2[i], length - i, stop));
+}
+
+#endif
+/**********************************************************************/
+
+#undef KERNEL_NAME
+#undef KERNEL_TYPE
+#undef KERNEL_SHIFT
+#undef KERNEL_SSE2_SET1
+#undef KERNEL_SSE2_CMPEQ
+#undef KERNEL_AVX2_SET1
+#undef KERNEL_AVX2_CMPEQ
@@ -22,6 +22,7 @@
  *
  **********************************************************************/
 
+#include "output.h"
 #include "sort.h"
 #include "table.h"
 #include "text.h"
@@ -93,29 +94,34 @@ Boolean suspect;
 void process_file(filename)
 char *filename;
 {
-    Char *start, *c;
+    long start, c;
     char key[MAX_N * STRING_SIZE], string[STRING_SIZE];
     Boolean suspect;
     short i;
     Charvalue value[MAX_N];
-    list_empty(&text, free);
+    Arena *arena, *previous;
+    /* The text is taken from an arena of its own, and released at once;
+     * the sequences outlive it, so they are taken from the heap. */
+    arena = new_arena();
+    previous = use_arena(arena);
     read_text(&text, filename, &textopt);
-    for (start = text.first; start; start = start->next)
+    use_arena(previous);
+    for (start = 0; start + n <= text.count; start++)
     {
 	key[0] = '\0';
 	suspect = False;
-	for (i = 0, c = start; i < n; i++, c = c->next)
+	for (i = 0, c = start; i < n; i++, c++)
 	{
-	    if (!c)
-		return;
-	    char_to_string(False, c->value, string, True);
+	    char_to_string(False, TEXT_VALUE(&text, c), string, True);
 	    strcat(key, string);
-	    value[i] = c->value;
-	    if (c->suspect)
+	    value[i] = TEXT_VALUE(&text, c);
+	    if (TEXT_SUSPECT(&text, c))
 		suspect = True;
 	}
 	add_sequence(key, value, suspect);
     }
+    text_initialize(&text);
+    free_arena(arena);
 }
 /**********************************************************************/
 
@@ -141,26 +147,46 @@ Sequence *sequence1, *sequence2;
 }
 /**********************************************************************/
 
-void write_array()
+void write_counts(output, count, suspect)
+Output *output;
+long count, suspect;
+{
+    output_long(output, count, 8);
+    OUTPUT_BYTE(output, ' ');
+    output_long(output, suspect, 8);
+    output_string(output, "   ");
+}
+/**********************************************************************/
+
+void write_array(output)
+Output *output;
 {
     long i;
-    printf("   Count  Suspect\n");
+    output_string(output, "   Count  Suspect\n");
     for (i = 0; i < seqtable.count; i++)
-	printf("%8ld %8ld   {%s}\n", seqtable.array[i]->count,
-	seqtable.array[i]->suspect, seqtable.array[i]->key);
-    printf("%8ld %8ld   Total\n", seqtable.total_count,
-    seqtable.total_suspect);
+    {
+	write_counts(output, seqtable.array[i]->count,
+	seqtable.array[i]->suspect);
+	OUTPUT_BYTE(output, '{');
+	output_string(output, seqtable.array[i]->key);
+	output_string(output, "}\n");
+    }
+    write_counts(output, seqtable.total_count, seqtable.total_suspect);
+    output_string(output, "Total\n");
 }
 /**********************************************************************/
 
 void write_report()
 {
+    Output output;
+    open_output(&output, NULL);
     table_in_array(&seqtable);
     sort(seqtable.count, seqtable.array, order_by_value);
-    write_array();
-    printf("\n\n");
+    write_array(&output);
+    output_string(&output, "\n\n");
     sort(seqtable.count, seqtable.array, order_by_count);
-    write_array();
+    write_array(&output);
+    close_output(&output);
 }
 /**********************************************************************/
 
@@ -0,0 +1,161 @@
+/**********************************************************************
+ *
+ *  output.c
+ *
+ * Copyright 2026 ocreval contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You
+ * may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ **********************************************************************/
+
+#include <errno.h>
+#include <unistd.h>
+
+#include "output.h"
+
+/* Room left in the buffer for the longest representation of a character,
+ * such as "^<10FFFF>". */
+#define CHAR_ROOM  16
+
+/* Digits in the longest long, with its sign. */
+#define LONG_DIGITS  24
+
+/**********************************************************************/
+
+void open_output(output, filename)
+Output *output;
+char *filename;
+{
+    output->f = open_file(filename, "w");
+    output->buffer = NEW_ARRAY(OUTPUT_BUFFER_SIZE, char);
+    output->count = 0;
+}
+/**********************************************************************/
+
+void close_output(output)
+Output *output;
+{
+    flush_output(output);
+    close_file(output->f);
+    DISPOSE_ARRAY(output->buffer);
+    output->buffer = NULL;
+}
+/**********************************************************************/
+
+void flush_output(output)
+Output *output;
+{
+    long written = 0;
+    ssize_t n;
+    if (fflush(output->f) != 0)
+	error("unable to write output");
+    while (written < output->count)
+    {
+	n = write(fileno(output->f), &output->buffer[written],
+	output->count - written);
+	if (n < 0 && errno != EINTR)
+	    error("unable to write output");
+	if (n > 0)
+	    written += n;
+    }
+    output->count = 0;
+}
+/**********************************************************************/
+
+void output_bytes(output, bytes, length)
+Output *output;
+char *bytes;
+long length;
+{
+    long n;
+    while (length > 0)
+    {
+	if (output->count == OUTPUT_BUFFER_SIZE)
+	    flush_output(output);
+	n = min(length, OUTPUT_BUFFER_SIZE - output->count);
+	memcpy(&output->buffer[output->count], bytes, n);
+	output->count += n;
+	bytes += n;
+	length -= n;
+    }
+}
+/**********************************************************************/
+
+void output_string(output, string)
+Output *output;
+char *string;
+{
+    output_bytes(output, string, (long) strlen(string));
+}
+/**********************************************************************/
+
+void output_padded(output, string, width)
+Output *output;
+char *string;
+long width;
+{
+    long length = strlen(string);
+    output_bytes(output, string, length);
+    for (; length < width; length++)
+	OUTPUT_BYTE(output, ' ');
+}
+/**********************************************************************/
+
+void output_long(output, value, width)
+Output *output;
+long value;
+short width;
+{
+    char digits[LONG_DIGITS];
+    unsigned long magnitude;
+    short i = LONG_DIGITS;
+    magnitude = (value < 0 ? - (unsigned long) value : (unsigned long) value);
+    do
+    {
+	digits[--i] = '0' + magnitude % 10;
+	magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0)
+	digits[--i] = '-';
+    for (; width > LONG_DIGITS - i; width--)
+	OUTPUT_BYTE(output, ' ');
+    output_bytes(output, &digits[i], (long) (LONG_DIGITS - i));
+}
+/**********************************************************************/
+
+void output_fixed(output, value, width, precision)
+Output *output;
+double value;
+short width, precision;
+{
+    char string[64];
+    sprintf(string, "%*.*f", width, precision, value);
+    output_string(output, string);
+}
+/**********************************************************************/
+
+void output_char(output, suspect, value, fake_newline)
+Output *output;
+Boolean suspect;
+Charvalue value;
+Boolean fake_newline;
+{
+    if (output->count > OUTPUT_BUFFER_SIZE - CHAR_ROOM)
+	flush_output(output);
+    /* Every printable ASCII character represents itself. */
+    if (!suspect && value >= ' ' && value < 0x7F)
+	output->buffer[output->count++] = value;
+    else
+	output->count += char_to_string(suspect, value,
+	&output->buffer[output->count], fake_newline);
+}
@@ -0,0 +1,88 @@
+/**********************************************************************
+ *
+ *  output.h
+ *
+ *  This module provides buffered output for texts and reports.  Bytes
+ *  are formatted directly into a large buffer, which is written to the
+ *  file with a single call to "write" each time it fills.  Printable
+ *  ASCII characters and integers are formatted without "printf".
+ *
+ *  Output written through the stdio functions to the same file before
+ *  the Output is opened, or between flushes, is written first.
+ *
+ * Copyright 2026 ocreval contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You
+ * may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ **********************************************************************/
+
+#ifndef _OUTPUT_
+#define _OUTPUT_
+
+#include "text.h"
+
+#define OUTPUT_BUFFER_SIZE  65536
+
+typedef
+struct
+{
+    FILE *f;            /* file returned by "open_file" */
+    char *buffer;       /* bytes not yet written */
+    long count;         /* number of bytes in the buffer */
+} Output;
+
+void open_output(/* Output *output, char *filename */);
+                        /* opens the named file (or stdout if "filename" is
+                           NULL) for output; reports an error and quits if
+                           unable to create the file */
+
+void close_output(/* Output *output */);
+                        /* flushes and closes the output */
+
+void flush_output(/* Output *output */);
+                        /* writes the buffered bytes to the file; reports an
+                           error and quits if unable to write them */
+
+void output_bytes(/* Output *output, char *bytes, long length */);
+                        /* appends "length" bytes to the output */
+
+void output_string(/* Output *output, char *string */);
+                        /* appends a null-terminated string to the output */
+
+void output_padded(/* Output *output, char *string, long width */);
+                        /* appends "string" followed by enough spaces to make
+                           it "width" characters wide, like "%-*s" */
+
+void output_long(/* Output *output, long value, short width */);
+                        /* appends the decimal representation of "value",
+                           right-justified in a field of "width" characters,
+                           like "%*ld" */
+
+void output_fixed(/* Output *output, double value, short width,
+                     short precision */);
+                        /* appends "value" with "precision" decimal places,
+                           right-justified in a field of "width" characters,
+                           like "%*.*f" */
+
+void output_char(/* Output *output, Boolean suspect, Charvalue value,
+                    Boolean fake_newline */);
+                        /* appends the representation of the given character
+                           given by "char_to_string" */
+
+#define OUTPUT_BYTE(output, byte) \
+    ((void) ((output)->count < OUTPUT_BUFFER_SIZE || \
+    (flush_output(output), 0)), \
+    (void) ((output)->buffer[(output)->count++] = (byte)))
+                        /* appends one byte to the output */
+
+#endif
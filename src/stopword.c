@@ -93,7 +93,7 @@ char *filename;
     {
 	read_text(&text, filename, &textopt);
 	find_words(&wordlist, &text);
-	list_empty(&text, free);
+	text_empty(&text);
 	for (word = wordlist.first; word; word = word->next)
 	    save_stopword(word->string);
     }
@@ -0,0 +1,202 @@
+/**********************************************************************
+ *
+ *  suffix.c
+ *
+ * Copyright 2026 ocreval contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You
+ * may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ **********************************************************************/
+
+#include "suffix.h"
+
+/* The two ranges are joined by a separator into one string of "length"
+ * symbols.  Each reject character, and the separator, is given a symbol
+ * of its own above every character value, so that no common prefix
+ * extends over one. */
+#define UNIQUE_SYMBOL(i)  ((long) NUM_CHARVALUES + 1 + (i))
+
+typedef
+struct
+{
+    long length;
+    long *symbol;       /* the symbols of the string */
+    long *suffix;       /* starting positions of the suffixes, in order */
+    long *rank;         /* position of each suffix in order of its first
+                           "h" symbols, equal for equal prefixes */
+    long *lcp;          /* lcp[i] is the length of the common prefix of
+                           suffix[i - 1] and suffix[i] */
+} Suffixes;             /* the suffix array of one string, so that several
+                           may be built at once by different threads */
+
+typedef
+struct
+{
+    long symbol, position;
+} Start;                /* a suffix, by its first symbol */
+
+/**********************************************************************/
+
+static int compare_starts(start1, start2)
+const void *start1, *start2;
+{
+    const Start *s1 = start1, *s2 = start2;
+    if (s1->symbol != s2->symbol)
+	return(s1->symbol < s2->symbol ? -1 : 1);
+    return(s1->position < s2->position ? -1 : s1->position > s2->position);
+}
+/**********************************************************************/
+
+/* Sorts the suffixes by prefix doubling: once they are ordered by their
+ * first h symbols, they are ordered by their first 2 h symbols by a
+ * counting sort on the rank of their first h symbols, stable over their
+ * order by the next h. */
+static void sort_suffixes(suffixes)
+Suffixes *suffixes;
+{
+    long length = suffixes->length, *symbol = suffixes->symbol;
+    long *suffix = suffixes->suffix, *rank = suffixes->rank;
+    long *order, *count, *new_rank, h, i, j;
+    Start *start;
+    order = NEW_ARRAY(length, long);
+    count = NEW_ARRAY(length + 1, long);
+    new_rank = NEW_ARRAY(length, long);
+    start = NEW_ARRAY(length, Start);
+    for (i = 0; i < length; i++)
+    {
+	start[i].symbol = symbol[i];
+	start[i].position = i;
+    }
+    qsort(start, (size_t) length, sizeof(Start), compare_starts);
+    for (i = 0; i < length; i++)
+	suffix[i] = start[i].position;
+    DISPOSE_ARRAY(start);
+    rank[suffix[0]] = 0;
+    for (i = 1; i < length; i++)
+	rank[suffix[i]] = rank[suffix[i - 1]] +
+	(symbol[suffix[i]] != symbol[suffix[i - 1]] ? 1 : 0);
+    for (h = 1; rank[suffix[length - 1]] < length - 1; h *= 2)
+    {
+	j = 0;
+	for (i = length - h; i < length; i++)
+	    order[j++] = i;
+	for (i = 0; i < length; i++)
+	    if (suffix[i] >= h)
+		order[j++] = suffix[i] - h;
+	memset(count, 0, (length + 1) * sizeof(long));
+	for (i = 0; i < length; i++)
+	    count[rank[i] + 1]++;
+	for (i = 1; i <= length; i++)
+	    count[i] += count[i - 1];
+	for (i = 0; i < length; i++)
+	    suffix[count[rank[order[i]]]++] = order[i];
+	new_rank[suffix[0]] = 0;
+	for (i = 1; i < length; i++)
+	    new_rank[suffix[i]] = new_rank[suffix[i - 1]] +
+	    (rank[suffix[i]] != rank[suffix[i - 1]] ||
+	    (suffix[i] + h < length ? rank[suffix[i] + h] : -1) !=
+	    (suffix[i - 1] + h < length ? rank[suffix[i - 1] + h] : -1) ?
+	    1 : 0);
+	memcpy(rank, new_rank, length * sizeof(long));
+    }
+    DISPOSE_ARRAY(new_rank);
+    DISPOSE_ARRAY(count);
+    DISPOSE_ARRAY(order);
+}
+/**********************************************************************/
+
+/* Finds the common prefixes of adjacent suffixes by the method of Kasai
+ * et al., in which each is at most one shorter than the previous one in
+ * order of position. */
+static void find_common_prefixes(suffixes)
+Suffixes *suffixes;
+{
+    long length = suffixes->length, *symbol = suffixes->symbol;
+    long *suffix = suffixes->suffix, *rank = suffixes->rank;
+    long *lcp = suffixes->lcp, i, j, h = 0;
+    lcp[0] = 0;
+    for (i = 0; i < length; i++)
+	if (rank[i] > 0)
+	{
+	    j = suffix[rank[i] - 1];
+	    while (i + h < length && j + h < length &&
+	    symbol[i + h] == symbol[j + h])
+		h++;
+	    lcp[rank[i]] = h;
+	    if (h > 0)
+		h--;
+	}
+	else
+	    h = 0;
+}
+/**********************************************************************/
+
+long longest_common_substring(maxlen, text1, start1, stop1, text2, start2,
+stop2, mstart1, mstart2)
+long maxlen, start1, stop1, start2, stop2, *mstart1, *mstart2;
+Text *text1, *text2;
+{
+    Suffixes suffixes;
+    long length1 = stop1 - start1 + 1, best = 0, first1, first2, i, j;
+    long length, *symbol, *suffix, *lcp;
+    Charvalue value;
+    if (length1 <= maxlen || stop2 - start2 + 1 <= maxlen)
+	return(maxlen);
+    length = suffixes.length = length1 + 1 + stop2 - start2 + 1;
+    symbol = suffixes.symbol = NEW_ARRAY(length, long);
+    suffix = suffixes.suffix = NEW_ARRAY(length, long);
+    suffixes.rank = NEW_ARRAY(length, long);
+    lcp = suffixes.lcp = NEW_ARRAY(length, long);
+    for (i = 0; i < length; i++)
+    {
+	value = (i < length1 ? TEXT_VALUE(text1, start1 + i) : i == length1 ?
+	REJECT_CHARACTER : TEXT_VALUE(text2, start2 + i - length1 - 1));
+	symbol[i] = (value == REJECT_CHARACTER ? UNIQUE_SYMBOL(i) :
+	(long) value);
+    }
+    sort_suffixes(&suffixes);
+    find_common_prefixes(&suffixes);
+    /* The longest common substring is a common prefix of two adjacent
+     * suffixes, one from each range. */
+    for (i = 1; i < length; i++)
+	if (lcp[i] > best && (suffix[i] < length1) != (suffix[i - 1] < length1))
+	    best = lcp[i];
+    if (best > maxlen)
+    {
+	/* Each run of adjacent suffixes sharing a prefix of "best" symbols
+	 * holds every occurrence of one longest common substring. */
+	*mstart1 = length;
+	for (i = 0; i < length; i = j)
+	{
+	    first1 = first2 = length;
+	    for (j = i; j < length && (j == i || lcp[j] >= best); j++)
+		if (suffix[j] < length1)
+		    first1 = min(first1, suffix[j]);
+		else
+		    first2 = min(first2, suffix[j]);
+	    if (first1 < *mstart1 && first2 < length && j - i > 1)
+	    {
+		*mstart1 = first1;
+		*mstart2 = first2;
+	    }
+	}
+	*mstart1 += start1;
+	*mstart2 += start2 - length1 - 1;
+	maxlen = best;
+    }
+    DISPOSE_ARRAY(lcp);
+    DISPOSE_ARRAY(suffixes.rank);
+    DISPOSE_ARRAY(suffix);
+    DISPOSE_ARRAY(symbol);
+    return(maxlen);
+}
@@ -0,0 +1,46 @@
+/**********************************************************************
+ *
+ *  suffix.h
+ *
+ *  This module finds a longest common substring of two ranges of
+ *  characters with a suffix array of both, sorted by prefix doubling,
+ *  and the lengths of the longest common prefixes of adjacent suffixes.
+ *  This takes time proportional to n log n for n characters in all,
+ *  where comparing every pair of starting positions takes time
+ *  proportional to the product of the lengths of the ranges.
+ *
+ * Copyright 2026 ocreval contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You
+ * may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ **********************************************************************/
+
+#ifndef _SUFFIX_
+#define _SUFFIX_
+
+#include "text.h"
+
+long longest_common_substring(/* long maxlen, Text *text1, long start1,
+				 long stop1, Text *text2, long start2,
+				 long stop2, long *mstart1, long *mstart2 */);
+			/* finds the longest substring common to characters
+			   "start1" through "stop1" of "text1" and "start2"
+			   through "stop2" of "text2", containing no reject
+			   character; if it is longer than "maxlen", returns
+			   its length and stores its starting positions in
+			   "mstart1" and "mstart2", else returns "maxlen";
+			   among several such substrings, the one starting
+			   first in "text1" is chosen, then its first
+			   occurrence in "text2" */
+
+#endif
@@ -22,26 +22,167 @@
  *
  **********************************************************************/
 
+#include <math.h>
+#include <pthread.h>
 #include <stdint.h>
 
+#include "bitsync.h"
+#include "match.h"
+#include "suffix.h"
 #include "sync.h"
 
 #define MIN_STREAMS   2
-#define MAX_STREAMS  16
 
 /* #define SHOW_FASTUKK_REDUCTION */
 
+/* Ukkonen's algorithm takes about p * p steps to find an alignment with
+ * p edits, and the bit-parallel one m n / 64 steps for any alignment.  A
+ * step of the first costs about as much as this many of the second. */
+#define DIAGONAL_COST  3
+
+/* The bit-parallel algorithm is never chosen automatically when it needs
+ * more than this many bytes. */
+#define MAX_BIT_PARALLEL_SIZE  (1024.0 * 1024 * 1024)
+
+/* When Ukkonen's algorithm would keep more than this many bytes of
+ * paths, it recomputes them instead. */
+#define MAX_PATHLIST_SIZE  (256.0 * 1024 * 1024)
+
+/* A longest common substring is found with a suffix array when there are
+ * more than this many pairs of starting positions per character. */
+#define SUFFIX_ARRAY_PAIRS  64
+
+/* In SYNC_ANCHORED mode, substrings of this many characters occurring
+ * once in each text are taken as anchors; they are found by a rolling
+ * hash with this base. */
+#define ANCHOR_LENGTH  12
+#define ANCHOR_BASE    ((uint64_t) 16777619)
+
+/* The anchors are trusted only if, with the common prefix and suffix,
+ * they match at least this fraction of the shorter text; sparser ones are
+ * likely to be unique by chance, and the texts are aligned optimally
+ * instead. */
+#define MIN_ANCHOR_COVERAGE  0.25
+
+/* A round of an approximate alignment that cannot reach the end commits
+ * only to a point reached by a snake of at least this many characters,
+ * as "diff" does; a round with no such point is run again with twice the
+ * cost, up to this many times the cost it was given. */
+#define MIN_COMMIT_SNAKE  20
+#define MAX_ROUND_GROWTH  16
+
+/* A path is divided among the threads only when each would compute at
+ * least this many diagonals of it. */
+#define MIN_WAVEFRONT_SHARE  1024
+
+/* Results of "compute_pathlist". */
+#define COMPLETE        0
+#define TOO_MANY_EDITS  1
+#define TOO_LARGE       2
+
 /* Support up to 2**32 characters. */
 typedef uint_fast32_t F;
 #define MAX_F     INT_FAST32_MAX
 
-BEGIN_ITEM(Diag)
-    F f;
-END_ITEM(Diag);
+typedef
+struct
+{
+    uint64_t hash;      /* hash code of the substring, or 0 if none */
+    long count[2];      /* occurrences in each text */
+    long start[2];      /* position of the last occurrence in each text */
+} Kmer;                 /* an entry of the hash table of anchors */
+
+typedef
+struct
+{
+    long start[2];
+    long length;
+} Segment;              /* a substring matched in both texts */
+
+typedef
+struct
+{
+    long start, length; /* characters of the line, with its NEWLINE */
+    uint64_t hash;      /* hash code of the line, or 0 if it has a reject
+                           character */
+} Line;
+
+typedef
+struct
+{
+    Text *text;
+    Line *line[2];      /* the lines of each text */
+    long *pair[2];      /* lines pair[0][i] and pair[1][i] are matched, in
+                           increasing order */
+    long num_pair;
+} Linediff;             /* the state of "line_sync" */
+
+typedef
+struct
+{
+    long start[SYNC_MAX_STREAMS], stop[SYNC_MAX_STREAMS];
+} Range;                /* characters start[i] through stop[i] of each text,
+                           left to be matched by "synchronize" */
+
+typedef
+struct
+{
+    long start[SYNC_MAX_STREAMS];
+    long length;
+} Found;                /* a substring matched by "synchronize" */
+
+typedef
+struct
+{
+    Range *range;       /* ranges range[first] through range[first + count
+                           - 1]; the worker takes the last, and the others
+                           steal the first */
+    long first, count, size;
+    Found *found;       /* the matches the worker has found */
+    long num_found, found_size;
+    pthread_mutex_t mutex;
+} Deque;                /* the work of a thread of "synchronize" */
+
+typedef
+struct
+{
+    short num_text;
+    Text *text;
+    Deque deque[SYNC_MAX_THREADS];
+    short num_deque;
+    long pending;       /* ranges queued or being matched */
+    long generation;    /* number of times ranges were queued */
+    pthread_mutex_t mutex;
+    pthread_cond_t queued;
+} Pool;                 /* the threads of "synchronize", which match the
+                           ranges between the matches found so far */
+
+typedef
+struct
+{
+    Pool *pool;
+    short index;
+} Poolworker;
+
+typedef
+struct
+{
+    long length;        /* length of the match, or a bound on it */
+    Boolean evaluated;  /* True once "length" is that of the match */
+    Sync *sync1, *sync2;/* the unmatched substrings */
+    long order1, order2;/* their starting positions when queued */
+    long start1, start2;/* starting positions of the match */
+} Candidate;            /* a pair of substrings for "transpose_sync" */
+
+typedef
+struct
+{
+    Candidate *candidate;
+    long count, size;
+} Queue;                /* candidates of "transpose_sync", in a heap ordered
+                           by "precedes" */
 
-BEGIN_LIST_OF(Diag)
-END_LIST(Diaglist);
-static Diaglist diaglist;
+#define MIN_QUEUE_SIZE  256
 
 BEGIN_ITEM(Path)
     long p, start_k, stop_k;
@@ -50,11 +191,91 @@ END_ITEM(Path);
 
 BEGIN_LIST_OF(Path)
 END_LIST(Pathlist);
-static Pathlist pathlist;
 
-static Char **a, **b;
+/* The diagonals of the path being computed are gathered in the middle of
+ * a buffer, which grows at both ends; it is reused for every path. */
+#define MIN_DIAG_SIZE  256
+
+typedef
+struct
+{
+    Syncstate *state;
+    short index;        /* share of each wavefront computed by the worker */
+    long generation;    /* last wavefront seen by the worker */
+} Worker;
+
+/* The state of an alignment by Ukkonen's algorithm, kept by a
+ * "Synccontext" so that its buffers are reused.  When a path is divided
+ * among the threads, the furthest row reached on each diagonal k from
+ * wave_lo through wave_hi is put in wave_f[k - wave_lo], and compute_path
+ * then takes the diagonals it needs from there, in the same order as when
+ * computing them itself.  The workers are started by the first alignment
+ * that needs them, wait on wave_start between alignments, and are only
+ * stopped when the context is freed. */
+struct syncstate
+{
+    Textvalue a, b;
+    long (*snake)();
+    long m, n, n_m, min_k, max_k;
+    Pathlist pathlist;
+    F *diag_f;
+    long diag_size, diag_first, diag_last;
+                        /* the diagonals are at diag_first through
+                           diag_last - 1 */
+    short threads;
+    pthread_t thread[SYNC_MAX_THREADS];
+    Worker worker[SYNC_MAX_THREADS];
+    short num_workers;  /* workers started */
+    short wave_workers; /* workers taking part in the current alignment */
+    pthread_mutex_t wave_mutex;
+    pthread_cond_t wave_start, wave_done;
+    long wave_generation;
+                        /* number of wavefronts handed to the workers */
+    short wave_pending; /* workers still computing the current wavefront */
+    Boolean wave_quit;
+    Path *wave_path;
+    long wave_lo, wave_hi, wave_size;
+    F *wave_f;
+};
+
+typedef
+struct
+{
+    long start[2], stop[2];
+    Syncarray matches;  /* the matches aligning the gap */
+} Gap;                  /* characters start[i] through stop[i] - 1 of each
+                           text, between two segments */
+
+typedef
+struct
+{
+    Text *text;
+    Gap *gap;
+    long num_gap, next_gap;
+    pthread_mutex_t mutex;
+} Gaplist;              /* the gaps of "anchored_sync", taken in turn by
+                           the threads aligning them */
+
+typedef
+struct
+{
+    Text *text;
+    short num_text, center;
+    short method, threads;
+                        /* as in "Synccontext", for each alignment */
+    Syncarray *pair;    /* pair[i] aligns the center with text i */
+    short next_text;
+    pthread_mutex_t mutex;
+} Star;                 /* the state of "center_sync", whose alignments
+                           are taken in turn by the threads */
 
-static long m, n, n_m, min_k, max_k;
+short synchronize_threads = 1;
+short fastukk_method = SYNC_AUTOMATIC;
+short fastukk_threads = 1;
+long fastukk_anchor_coverage;
+long fastukk_max_edits = -1;
+long fastukk_max_cost = -1;
+long fastukk_excess;
 
 /**********************************************************************/
 
@@ -71,8 +292,8 @@ short num_text;
 static void destroy_sync(sync)
 Sync *sync;
 {
-    free(sync->substr);
-    free(sync);
+    DISPOSE_ARRAY(sync->substr);
+    DISPOSE(sync, Sync);
 }
 /**********************************************************************/
 
@@ -99,7 +320,6 @@ Text *text;
     sync = create_sync(num_text);
     for (i = 0; i < num_text; i++)
     {
-	list_in_array(&text[i]);
 	sync->substr[i].start  = 0;
 	sync->substr[i].stop   = text[i].count - 1;
 	sync->substr[i].length = text[i].count;
@@ -111,33 +331,245 @@ Text *text;
 }
 /**********************************************************************/
 
-static long longest_match(maxlen, c1, start1, stop1, c2, start2, stop2, mstart1,
-mstart2)
-long maxlen, start1, stop1, start2, stop2, *mstart1, *mstart2;
-Char *c1[], *c2[];
-{
-    long s1limit, s2limit, s1, s2, i1, i2, increase;
-    s1limit = stop1 - maxlen;
-    s2limit = stop2 - maxlen;
-    for (s1 = start1; s1 <= s1limit; s1++)
-	for (s2 = start2; s2 <= s2limit; s2++)
-	    if (c1[s1]->value == c2[s2]->value &&
-	    c1[s1]->value != REJECT_CHARACTER)
+static void initialize_syncarray(array, num_text)
+Syncarray *array;
+short num_text;
+{
+    memset(array, 0, sizeof(Syncarray));
+    array->num_text = num_text;
+}
+/**********************************************************************/
+
+/* Moves the items of "array" to a block with room for "size" of them. */
+static void resize_syncarray(array, size)
+Syncarray *array;
+long size;
+{
+    Syncarray old;
+    long *block;
+    short i, num_text = array->num_text;
+    old = *array;
+    block = NEW_ARRAY((3 * num_text + 1) * size, long);
+    array->match = block;
+    for (i = 0; i < num_text; i++)
+    {
+	array->start[i]  = block + (1 + i) * size;
+	array->stop[i]   = block + (1 + num_text + i) * size;
+	array->length[i] = block + (1 + 2 * num_text + i) * size;
+    }
+    array->size = size;
+    if (old.count > 0)
+    {
+	memcpy(array->match, old.match, old.count * sizeof(long));
+	for (i = 0; i < num_text; i++)
+	{
+	    memcpy(array->start[i], old.start[i], old.count * sizeof(long));
+	    memcpy(array->stop[i], old.stop[i], old.count * sizeof(long));
+	    memcpy(array->length[i], old.length[i], old.count * sizeof(long));
+	}
+    }
+    if (old.size > 0)
+	DISPOSE_ARRAY(old.match);
+}
+/**********************************************************************/
+
+/* Adds to the end of "array" the substrings start[i] through stop[i] - 1
+ * of each text, with match number "match", unless they are all empty. */
+static void add_item(array, start, stop, match)
+Syncarray *array;
+long *start, *stop, match;
+{
+    long k = array->count;
+    short i;
+    for (i = 0; i < array->num_text && stop[i] == start[i]; i++);
+    if (i == array->num_text)
+	return;
+    if (k == array->size)
+	resize_syncarray(array, max(16, 2 * array->size));
+    for (i = 0; i < array->num_text; i++)
+    {
+	array->start[i][k]  = start[i];
+	array->stop[i][k]   = stop[i] - 1;
+	array->length[i][k] = stop[i] - start[i];
+    }
+    array->match[k] = match;
+    array->count++;
+}
+/**********************************************************************/
+
+/* Adds to the end of "array" a match of "length" characters starting at
+ * start[i] in each text. */
+static void add_match(array, start, length)
+Syncarray *array;
+long *start, length;
+{
+    long stop[SYNC_MAX_STREAMS];
+    short i;
+    for (i = 0; i < array->num_text; i++)
+	stop[i] = start[i] + length;
+    add_item(array, start, stop, 1L);
+}
+/**********************************************************************/
+
+/* Completes "array", whose items so far are the matches, added either
+ * from first to last or from last to first: the unmatched substrings of
+ * "text" are put between them, all at once, and they are numbered. */
+static void close_syncarray(array, text)
+Syncarray *array;
+Text *text;
+{
+    Syncarray matches;
+    long start[SYNC_MAX_STREAMS], stop[SYNC_MAX_STREAMS], k, m;
+    short i, num_text = array->num_text;
+    Boolean reversed;
+    matches = *array;
+    reversed = (matches.count > 1 &&
+    matches.start[0][0] > matches.start[0][1]);
+    initialize_syncarray(array, num_text);
+    resize_syncarray(array, 2 * matches.count + 1);
+    for (i = 0; i < num_text; i++)
+	start[i] = 0;
+    for (k = 0; k <= matches.count; k++)
+    {
+	m = (reversed ? matches.count - 1 - k : k);
+	for (i = 0; i < num_text; i++)
+	    stop[i] = (k < matches.count ? matches.start[i][m] : text[i].count);
+	add_item(array, start, stop, 0L);
+	if (k < matches.count)
+	{
+	    for (i = 0; i < num_text; i++)
 	    {
-		for (i1 = s1 + 1, i2 = s2 + 1; i1 <= stop1 && i2 <= stop2 &&
-		c1[i1]->value == c2[i2]->value &&
-		c1[i1]->value != REJECT_CHARACTER; i1++, i2++);
-		increase = i1 - s1 - maxlen;
-		if (increase > 0)
-		{
-		    s1limit -= increase;
-		    s2limit -= increase;
-		    maxlen  += increase;
-		    *mstart1 = s1;
-		    *mstart2 = s2;
-		}
+		start[i] = matches.start[i][m];
+		stop[i] = matches.stop[i][m] + 1;
 	    }
-    return(maxlen);
+	    add_item(array, start, stop, k + 1);
+	    for (i = 0; i < num_text; i++)
+		start[i] = stop[i];
+	}
+    }
+    free_syncarray(&matches);
+}
+/**********************************************************************/
+
+/* Makes "synclist" a list of the items of "array". */
+static void make_synclist(synclist, array)
+Synclist *synclist;
+Syncarray *array;
+{
+    Sync *sync;
+    long k;
+    short i;
+    list_initialize(synclist);
+    for (k = 0; k < array->count; k++)
+    {
+	sync = create_sync(array->num_text);
+	for (i = 0; i < array->num_text; i++)
+	{
+	    sync->substr[i].start  = array->start[i][k];
+	    sync->substr[i].stop   = array->stop[i][k];
+	    sync->substr[i].length = array->length[i][k];
+	}
+	if (array->match[k])
+	{
+	    sync->match = NEW(long);
+	    *sync->match = array->match[k];
+	}
+	list_insert_last(synclist, sync);
+    }
+}
+/**********************************************************************/
+
+Sync *first_sync(view, array)
+Syncview *view;
+Syncarray *array;
+{
+    view->array = array;
+    view->index = -1;
+    view->sync.prev = view->sync.next = NULL;
+    view->sync.substr = view->substr;
+    return(next_sync(view));
+}
+/**********************************************************************/
+
+Sync *next_sync(view)
+Syncview *view;
+{
+    Syncarray *array = view->array;
+    long k;
+    short i;
+    k = ++view->index;
+    if (k >= array->count)
+	return(NULL);
+    for (i = 0; i < array->num_text; i++)
+    {
+	view->substr[i].start  = array->start[i][k];
+	view->substr[i].stop   = array->stop[i][k];
+	view->substr[i].length = array->length[i][k];
+    }
+    view->match = array->match[k];
+    view->sync.match = (view->match ? &view->match : NULL);
+    return(&view->sync);
+}
+/**********************************************************************/
+
+void free_syncarray(array)
+Syncarray *array;
+{
+    if (array->size > 0)
+	DISPOSE_ARRAY(array->match);
+    initialize_syncarray(array, array->num_text);
+}
+/**********************************************************************/
+
+#define KERNEL_NAME(name)  name ## _1
+#define KERNEL_TYPE        uint8_t
+#define KERNEL_FIELD       latin1
+#include "synckernel.h"
+
+#define KERNEL_NAME(name)  name ## _2
+#define KERNEL_TYPE        uint16_t
+#define KERNEL_FIELD       bmp
+#include "synckernel.h"
+
+#define KERNEL_NAME(name)  name ## _4
+#define KERNEL_TYPE        Charvalue
+#define KERNEL_FIELD       ucs4
+#include "synckernel.h"
+
+/* Kernels for texts of width 1, 2 and 4, indexed by width / 2. */
+static long (*longest_match_table[3])() =
+    { longest_match_1, longest_match_2, longest_match_4 };
+static long (*snake_table[3])() = { snake_1, snake_2, snake_4 };
+
+/**********************************************************************/
+
+static long longest_match(maxlen, text1, start1, stop1, text2, start2, stop2,
+mstart1, mstart2)
+long maxlen, start1, stop1, start2, stop2, *mstart1, *mstart2;
+Text *text1, *text2;
+{
+    double pairs;
+    /* Both ways find the same match. */
+    pairs = (double) (stop1 - start1 + 1 - maxlen) *
+    (stop2 - start2 + 1 - maxlen);
+    if (pairs > SUFFIX_ARRAY_PAIRS *
+    (double) (stop1 - start1 + 1 + stop2 - start2 + 1))
+	return(longest_common_substring(maxlen, text1, start1, stop1, text2,
+	start2, stop2, mstart1, mstart2));
+    return((*longest_match_table[text1->width >> 1])(maxlen, text1, start1,
+    stop1, text2, start2, stop2, mstart1, mstart2));
+}
+/**********************************************************************/
+
+static void match_widths(num_text, text)
+short num_text;
+Text *text;
+{
+    short i, width = 1;
+    for (i = 0; i < num_text; i++)
+	width = max(width, text[i].width);
+    for (i = 0; i < num_text; i++)
+	widen_text(&text[i], width);
 }
 /**********************************************************************/
 
@@ -188,37 +620,255 @@ Synclist *synclist;
 }
 /**********************************************************************/
 
-static void recursive_sync(synclist, num_text, text, sync)
-Synclist *synclist;
-short num_text;
-Text *text;
-Sync *sync;
+/* Adds "range" to the end of "deque". */
+static void push_range(deque, range)
+Deque *deque;
+Range *range;
 {
-    short i, j;
-    long start[MAX_STREAMS], length, new_start, change;
+    Range *old_range;
+    pthread_mutex_lock(&deque->mutex);
+    if (deque->first + deque->count == deque->size)
+    {
+	if (deque->first > 0)
+	    memmove(deque->range, deque->range + deque->first,
+	    deque->count * sizeof(Range));
+	else
+	{
+	    old_range = deque->range;
+	    deque->size = max(2 * deque->size, 16);
+	    deque->range = NEW_ARRAY(deque->size, Range);
+	    if (old_range)
+	    {
+		memcpy(deque->range, old_range, deque->count * sizeof(Range));
+		DISPOSE_ARRAY(old_range);
+	    }
+	}
+	deque->first = 0;
+    }
+    deque->range[deque->first + deque->count++] = *range;
+    pthread_mutex_unlock(&deque->mutex);
+}
+/**********************************************************************/
+
+/* Takes a range from "deque", the last if "last" is True or else the
+ * first, and returns False if there is none. */
+static Boolean take_range(deque, range, last)
+Deque *deque;
+Range *range;
+Boolean last;
+{
+    Boolean taken = False;
+    pthread_mutex_lock(&deque->mutex);
+    if (deque->count > 0)
+    {
+	if (last)
+	    *range = deque->range[deque->first + deque->count - 1];
+	else
+	    *range = deque->range[deque->first++];
+	deque->count--;
+	taken = True;
+    }
+    pthread_mutex_unlock(&deque->mutex);
+    return(taken);
+}
+/**********************************************************************/
+
+/* Finds the longest substring common to the texts in "range", as each
+ * is compared in turn with the first, and queues the ranges on each side
+ * of it on "deque"; returns the number of ranges queued. */
+static short match_range(pool, deque, range)
+Pool *pool;
+Deque *deque;
+Range *range;
+{
+    Text *text = pool->text;
+    short num_text = pool->num_text, i, j, queued = 0;
+    long start[SYNC_MAX_STREAMS], length, new_start, change;
+    Found *old_found;
+    Range side;
     for (i = 0; i < num_text; i++)
-	if (sync->substr[i].length == 0)
-	    return;
-    start[0] = sync->substr[0].start;
-    length   = sync->substr[0].length;
+	if (range->stop[i] < range->start[i])
+	    return(0);
+    start[0] = range->start[0];
+    length   = range->stop[0] - range->start[0] + 1;
     for (i = 1; i < num_text; i++)
     {
 	length = longest_match(0,
-	text[0].array, start[0], start[0] + length - 1,
-	text[i].array, sync->substr[i].start, sync->substr[i].stop,
+	&text[0], start[0], start[0] + length - 1,
+	&text[i], range->start[i], range->stop[i],
 	&new_start, &start[i]);
 	if (length == 0)
-	    return;
+	    return(0);
 	change = new_start - start[0];
 	if (change > 0)
 	    for (j = 0; j < i; j++)
 		start[j] += change;
     }
-    save_match(synclist, num_text, sync, start, length, NEW(long));
-    if (sync->prev)
-	recursive_sync(synclist, num_text, text, sync->prev);
-    if (sync->next)
-	recursive_sync(synclist, num_text, text, sync->next);
+    if (deque->num_found == deque->found_size)
+    {
+	old_found = deque->found;
+	deque->found_size = max(2 * deque->found_size, 64);
+	deque->found = NEW_ARRAY(deque->found_size, Found);
+	if (old_found)
+	{
+	    memcpy(deque->found, old_found, deque->num_found * sizeof(Found));
+	    DISPOSE_ARRAY(old_found);
+	}
+    }
+    memcpy(deque->found[deque->num_found].start, start,
+    num_text * sizeof(long));
+    deque->found[deque->num_found++].length = length;
+    /* The range after the match is queued first, so that the one before
+     * it is taken next. */
+    for (j = 1; j >= 0; j--)
+    {
+	for (i = 0; i < num_text; i++)
+	{
+	    side.start[i] = (j == 0 ? range->start[i] : start[i] + length);
+	    side.stop[i]  = (j == 0 ? start[i] - 1 : range->stop[i]);
+	    if (side.stop[i] < side.start[i])
+		break;
+	}
+	if (i == num_text)
+	{
+	    push_range(deque, &side);
+	    queued++;
+	}
+    }
+    return(queued);
+}
+/**********************************************************************/
+
+/* Matches ranges, taking them from the end of deque "index", or else
+ * stealing them from the start of the others, until every range has been
+ * matched. */
+static void run_pool(pool, index)
+Pool *pool;
+short index;
+{
+    Range range;
+    long generation;
+    short queued, i;
+    Boolean done = False;
+    while (!done)
+    {
+	pthread_mutex_lock(&pool->mutex);
+	generation = pool->generation;
+	pthread_mutex_unlock(&pool->mutex);
+	for (i = 0; i < pool->num_deque && !take_range(&pool->deque[(index +
+	i) % pool->num_deque], &range, (i == 0 ? True : False)); i++);
+	pthread_mutex_lock(&pool->mutex);
+	if (i < pool->num_deque)
+	{
+	    pthread_mutex_unlock(&pool->mutex);
+	    queued = match_range(pool, &pool->deque[index], &range);
+	    pthread_mutex_lock(&pool->mutex);
+	    pool->pending += queued - 1;
+	    if (queued > 0)
+		pool->generation++;
+	    if (queued > 0 || pool->pending == 0)
+		pthread_cond_broadcast(&pool->queued);
+	}
+	else
+	    while (pool->pending > 0 && pool->generation == generation)
+		pthread_cond_wait(&pool->queued, &pool->mutex);
+	done = (pool->pending == 0);
+	pthread_mutex_unlock(&pool->mutex);
+    }
+}
+/**********************************************************************/
+
+static void *run_pool_worker(argument)
+void *argument;
+{
+    Poolworker *worker = (Poolworker *) argument;
+    run_pool(worker->pool, worker->index);
+    return(NULL);
+}
+/**********************************************************************/
+
+static int compare_found(found1, found2)
+Found *found1, *found2;
+{
+    return(found1->start[0] < found2->start[0] ? -1 :
+    found1->start[0] > found2->start[0] ? 1 : 0);
+}
+/**********************************************************************/
+
+void synchronize_array(array, num_text, text)
+Syncarray *array;
+short num_text;
+Text *text;
+{
+    Pool pool;
+    Poolworker worker[SYNC_MAX_THREADS];
+    pthread_t thread[SYNC_MAX_THREADS];
+    Arena *previous;
+    Range range;
+    Found *found;
+    long num_found = 0, k;
+    short num_threads = 0, i, j;
+    if (num_text < MIN_STREAMS || num_text > SYNC_MAX_STREAMS)
+	error("invalid number of text streams");
+    match_widths(num_text, text);
+    /* The ranges are matched on the heap, since the threads have no arena;
+     * each splits only its own range, so the matches are the same as when
+     * the ranges on each side of a match are matched in turn. */
+    previous = use_arena(NULL);
+    memset(&pool, 0, sizeof(Pool));
+    pool.num_text = num_text;
+    pool.text = text;
+    pool.num_deque = max(1, min(synchronize_threads, SYNC_MAX_THREADS));
+    pthread_mutex_init(&pool.mutex, NULL);
+    pthread_cond_init(&pool.queued, NULL);
+    for (j = 0; j < pool.num_deque; j++)
+	pthread_mutex_init(&pool.deque[j].mutex, NULL);
+    for (i = 0; i < num_text; i++)
+    {
+	range.start[i] = 0;
+	range.stop[i] = text[i].count - 1;
+    }
+    push_range(&pool.deque[0], &range);
+    pool.pending = 1;
+    for (j = 1; j < pool.num_deque; j++)
+    {
+	worker[j].pool = &pool;
+	worker[j].index = j;
+	if (pthread_create(&thread[num_threads], NULL, run_pool_worker,
+	(void *) &worker[j]) == 0)
+	    num_threads++;
+    }
+    run_pool(&pool, 0);
+    for (j = 0; j < num_threads; j++)
+	pthread_join(thread[j], NULL);
+    for (j = 0; j < pool.num_deque; j++)
+	num_found += pool.deque[j].num_found;
+    found = NEW_ARRAY(num_found + 1, Found);
+    for (j = 0, k = 0; j < pool.num_deque; j++)
+    {
+	if (pool.deque[j].num_found > 0)
+	{
+	    memcpy(found + k, pool.deque[j].found,
+	    pool.deque[j].num_found * sizeof(Found));
+	    k += pool.deque[j].num_found;
+	    DISPOSE_ARRAY(pool.deque[j].found);
+	}
+	if (pool.deque[j].range)
+	    DISPOSE_ARRAY(pool.deque[j].range);
+	pthread_mutex_destroy(&pool.deque[j].mutex);
+    }
+    pthread_cond_destroy(&pool.queued);
+    pthread_mutex_destroy(&pool.mutex);
+    qsort(found, num_found, sizeof(Found), compare_found);
+    use_arena(previous);
+    initialize_syncarray(array, num_text);
+    resize_syncarray(array, num_found + 1);
+    for (k = 0; k < num_found; k++)
+	add_match(array, found[k].start, found[k].length);
+    previous = use_arena(NULL);
+    DISPOSE_ARRAY(found);
+    use_arena(previous);
+    close_syncarray(array, text);
 }
 /**********************************************************************/
 
@@ -227,48 +877,164 @@ Synclist *synclist;
 short num_text;
 Text *text;
 {
-    if (num_text < MIN_STREAMS || num_text > MAX_STREAMS)
-	error("invalid number of text streams");
-    initialize_synclist(synclist, num_text, text);
-    if (synclist->first)
-	recursive_sync(synclist, num_text, text, synclist->first);
-    number_matches(synclist);
+    Syncarray array;
+    synchronize_array(&array, num_text, text);
+    make_synclist(synclist, &array);
+    free_syncarray(&array);
+}
+/**********************************************************************/
+
+/* Returns True if "candidate1" is to be taken before "candidate2": it
+ * is longer, or as long but only a bound to be evaluated, or else it
+ * comes first in the order in which the substrings were once compared
+ * pair by pair. */
+static Boolean precedes(candidate1, candidate2)
+Candidate *candidate1, *candidate2;
+{
+    if (candidate1->length != candidate2->length)
+	return(candidate1->length > candidate2->length);
+    if (candidate1->evaluated != candidate2->evaluated)
+	return(!candidate1->evaluated);
+    if (candidate1->order1 != candidate2->order1)
+	return(candidate1->order1 < candidate2->order1);
+    return(candidate1->order2 < candidate2->order2);
+}
+/**********************************************************************/
+
+static void push_candidate(queue, candidate)
+Queue *queue;
+Candidate *candidate;
+{
+    Candidate *old_candidate;
+    long i, parent;
+    if (queue->count == queue->size)
+    {
+	old_candidate = queue->candidate;
+	queue->size = max(2 * queue->size, MIN_QUEUE_SIZE);
+	queue->candidate = NEW_ARRAY(queue->size, Candidate);
+	if (old_candidate)
+	{
+	    memcpy(queue->candidate, old_candidate,
+	    queue->count * sizeof(Candidate));
+	    DISPOSE_ARRAY(old_candidate);
+	}
+    }
+    for (i = queue->count++; i > 0; i = parent)
+    {
+	parent = (i - 1) / 2;
+	if (!precedes(candidate, &queue->candidate[parent]))
+	    break;
+	queue->candidate[i] = queue->candidate[parent];
+    }
+    queue->candidate[i] = *candidate;
+}
+/**********************************************************************/
+
+static void pop_candidate(queue, candidate)
+Queue *queue;
+Candidate *candidate;
+{
+    Candidate *heap = queue->candidate, *last;
+    long i, child, count;
+    *candidate = heap[0];
+    count = --queue->count;
+    last = &heap[count];
+    for (i = 0; (child = 2 * i + 1) < count; i = child)
+    {
+	if (child + 1 < count && precedes(&heap[child + 1], &heap[child]))
+	    child++;
+	if (!precedes(&heap[child], last))
+	    break;
+	heap[i] = heap[child];
+    }
+    heap[i] = *last;
 }
 /**********************************************************************/
 
+/* Queues the pair of unmatched substrings "sync1" and "sync2", with the
+ * shorter of their lengths as a bound on the length of their match. */
+static void queue_pair(queue, sync1, sync2)
+Queue *queue;
+Sync *sync1, *sync2;
+{
+    Candidate candidate;
+    candidate.length = min(sync1->substr->length, sync2->substr->length);
+    candidate.evaluated = False;
+    candidate.sync1 = sync1;
+    candidate.sync2 = sync2;
+    candidate.order1 = sync1->substr->start;
+    candidate.order2 = sync2->substr->start;
+    push_candidate(queue, &candidate);
+}
+/**********************************************************************/
+
+/* Returns the unmatched substring just before or after the match "sync",
+ * which was just split from the one matched, or NULL. */
+#define SPLIT(neighbor)  ((neighbor) && !(neighbor)->match ? (neighbor) : NULL)
+
+/* Each match is the longest common substring of an unmatched substring of
+ * each text, and among several of them the first in the order of the
+ * unmatched substrings of the first text, then of the second, then of
+ * their positions.  Every pair of unmatched substrings is queued by the
+ * bound on its match, and evaluated only when this bound comes first;
+ * once a pair is matched, its substrings are split, and the pairs that
+ * involved them are dropped as they come up. */
 void transpose_sync(synclist1, synclist2, text1, text2)
 Synclist *synclist1, *synclist2;
 Text *text1, *text2;
 {
-    long length, newlength, start1, start2, *match;
-    Sync *s1, *s2, *sync1, *sync2;
+    Queue queue;
+    Candidate candidate;
+    Sync *new1[2], *new2[2], *sync;
+    long *match;
+    short i, j;
+    widen_text(text1, text2->width);
+    widen_text(text2, text1->width);
     initialize_synclist(synclist1, 1, text1);
     initialize_synclist(synclist2, 1, text2);
-    while (1)
+    queue.candidate = NULL;
+    queue.count = queue.size = 0;
+    if (synclist1->first && synclist2->first)
+	queue_pair(&queue, synclist1->first, synclist2->first);
+    while (queue.count > 0)
     {
-	length = 0;
-	for (s1 = synclist1->first; s1; s1 = s1->next)
-	    if (!s1->match && s1->substr->length > length)
-		for (s2 = synclist2->first; s2; s2 = s2->next)
-		    if (!s2->match && s2->substr->length > length)
-		    {
-			newlength = longest_match(length,
-			text1->array, s1->substr->start, s1->substr->stop,
-			text2->array, s2->substr->start, s2->substr->stop,
-			&start1, &start2);
-			if (newlength > length)
-			{
-			    length = newlength;
-			    sync1  = s1;
-			    sync2  = s2;
-			}
-		    }
-	if (length == 0)
-	    break;
+	pop_candidate(&queue, &candidate);
+	if (candidate.sync1->match || candidate.sync2->match)
+	    continue;
+	if (!candidate.evaluated)
+	{
+	    candidate.length = longest_match(0, text1,
+	    candidate.sync1->substr->start, candidate.sync1->substr->stop,
+	    text2, candidate.sync2->substr->start,
+	    candidate.sync2->substr->stop, &candidate.start1,
+	    &candidate.start2);
+	    candidate.evaluated = True;
+	    if (candidate.length > 0)
+		push_candidate(&queue, &candidate);
+	    continue;
+	}
 	match = NEW(long);
-	save_match(synclist1, 1, sync1, &start1, length, match);
-	save_match(synclist2, 1, sync2, &start2, length, match);
+	save_match(synclist1, 1, candidate.sync1, &candidate.start1,
+	candidate.length, match);
+	save_match(synclist2, 1, candidate.sync2, &candidate.start2,
+	candidate.length, match);
+	new1[0] = SPLIT(candidate.sync1->prev);
+	new1[1] = SPLIT(candidate.sync1->next);
+	new2[0] = SPLIT(candidate.sync2->prev);
+	new2[1] = SPLIT(candidate.sync2->next);
+	for (i = 0; i < 2; i++)
+	    if (new1[i])
+		for (sync = synclist2->first; sync; sync = sync->next)
+		    if (!sync->match)
+			queue_pair(&queue, new1[i], sync);
+	for (j = 0; j < 2; j++)
+	    if (new2[j])
+		for (sync = synclist1->first; sync; sync = sync->next)
+		    if (!sync->match && sync != new1[0] && sync != new1[1])
+			queue_pair(&queue, sync, new2[j]);
     }
+    if (queue.size > 0)
+	DISPOSE_ARRAY(queue.candidate);
     number_matches(synclist1);
 }
 /**********************************************************************/
@@ -300,148 +1066,1623 @@ Path *prev_path;
 }
 /**********************************************************************/
 
-static void compute_f(k, path)
+/* Returns an array of "count" F taken from the heap, so that it outlives
+ * the arena of the paths and can be reused by later alignments. */
+static F *new_scratch(count)
+long count;
+{
+    Arena *previous;
+    F *f;
+    previous = use_arena(NULL);
+    f = NEW_ARRAY(count, F);
+    use_arena(previous);
+    return(f);
+}
+/**********************************************************************/
+
+/* Doubles the size of "diag_f", centering the diagonals in it. */
+static void grow_diagonals(state)
+Syncstate *state;
+{
+    F *old_f = state->diag_f;
+    long count = state->diag_last - state->diag_first;
+    state->diag_size *= 2;
+    state->diag_f = new_scratch(state->diag_size);
+    memcpy(state->diag_f + (state->diag_size - count) / 2,
+    old_f + state->diag_first, count * sizeof(F));
+    DISPOSE_ARRAY(old_f);
+    state->diag_first = (state->diag_size - count) / 2;
+    state->diag_last = state->diag_first + count;
+}
+/**********************************************************************/
+
+/* Returns the furthest row reached on diagonal k with one edit more than
+ * "prev_path". */
+static long furthest(state, k, prev_path)
+Syncstate *state;
+long k;
+Path *prev_path;
+{
+    long i, prev_k;
+    i = initial_f(k, prev_path, &prev_k);
+    return((*state->snake)(state, i, i + k));
+}
+/**********************************************************************/
+
+static void compute_f(state, k, path)
+Syncstate *state;
 long k;
 Path *path;
 {
-    long i, j, value, bound;
-    Diag *diag;
-    i = initial_f(k, path->prev, &value);
+    long m = state->m, n = state->n, n_m = state->n_m, i, j, value, bound;
+    if (path == state->wave_path && k >= state->wave_lo &&
+    k <= state->wave_hi)
+	i = state->wave_f[k - state->wave_lo];
+    else
+	i = furthest(state, k, path->prev);
     j = i + k;
-    while (i < m && j < n && a[i]->value == b[j]->value &&
-    a[i]->value != REJECT_CHARACTER)
-    {
-	i++;
-	j++;
-    }
     if (i == m)
-	min_k = k + 1;
+	state->min_k = k + 1;
     if (j == n)
-	max_k = k - 1;
+	state->max_k = k - 1;
     bound = path->p + max(m, n - k) - i;
     value = (1 - bound + n_m) >> 1;
-    if (value > min_k)
-	min_k = value;
+    if (value > state->min_k)
+	state->min_k = value;
     value = (bound + n_m) >> 1;
-    if (value < max_k)
-	max_k = value;
-    diag = NEW(Diag);
-    diag->f = i;
-    if (diaglist.count == 0)
+    if (value < state->max_k)
+	state->max_k = value;
+    if (state->diag_first == state->diag_last)
     {
 	path->start_k = path->stop_k = k;
-	list_insert_last(&diaglist, diag);
+	state->diag_f[state->diag_last++] = i;
     }
     else
 	if (k < path->start_k)
 	{
 	    path->start_k = k;
-	    list_insert_first(&diaglist, diag);
+	    if (state->diag_first == 0)
+		grow_diagonals(state);
+	    state->diag_f[--state->diag_first] = i;
 	}
 	else
 	{
 	    path->stop_k = k;
-	    list_insert_last(&diaglist, diag);
+	    if (state->diag_last == state->diag_size)
+		grow_diagonals(state);
+	    state->diag_f[state->diag_last++] = i;
 	}
 }
 /**********************************************************************/
 
-static void compute_pathlist(text)
-Text *text;
+/* Computes share "index" of the wavefront of "wave_path". */
+static void compute_share(state, index)
+Syncstate *state;
+short index;
 {
-#ifdef SHOW_FASTUKK_REDUCTION
-    long ukkonen_count = 0, fastukk_count = 0, r, count;
-#endif
-    long p = -1, k, i;
-    Path *path;
-    Diag *diag;
-    a = text[0].array;
-    b = text[1].array;
-    m = text[0].count;
-    n = text[1].count;
-    n_m = n - m;
-    min_k = -m;
-    max_k =  n;
-    while (min_k <= n_m)
+    long count = state->wave_hi - state->wave_lo + 1, k, stop;
+    k = state->wave_lo + count * index / (state->wave_workers + 1);
+    stop = state->wave_lo + count * (index + 1) / (state->wave_workers + 1);
+    for ( ; k < stop; k++)
+	state->wave_f[k - state->wave_lo] = furthest(state, k,
+	state->wave_path->prev);
+}
+/**********************************************************************/
+
+static void *run_worker(argument)
+void *argument;
+{
+    Worker *worker = (Worker *) argument;
+    Syncstate *state = worker->state;
+    long generation = worker->generation;
+    pthread_mutex_lock(&state->wave_mutex);
+    for (;;)
     {
-	path = NEW(Path);
+	while (state->wave_generation == generation && !state->wave_quit)
+	    pthread_cond_wait(&state->wave_start, &state->wave_mutex);
+	if (state->wave_quit)
+	    break;
+	generation = state->wave_generation;
+	/* A worker beyond those of the current alignment sits it out. */
+	if (worker->index > state->wave_workers)
+	    continue;
+	pthread_mutex_unlock(&state->wave_mutex);
+	compute_share(state, worker->index);
+	pthread_mutex_lock(&state->wave_mutex);
+	if (--state->wave_pending == 0)
+	    pthread_cond_signal(&state->wave_done);
+    }
+    pthread_mutex_unlock(&state->wave_mutex);
+    return(NULL);
+}
+/**********************************************************************/
+
+/* Starts as many more workers as the current alignment needs, and
+ * decides how many of them take part in it. */
+static void start_workers(state)
+Syncstate *state;
+{
+    Worker *worker;
+    while (state->num_workers < min(state->threads, SYNC_MAX_THREADS) - 1)
+    {
+	worker = &state->worker[state->num_workers];
+	worker->state = state;
+	worker->index = state->num_workers + 1;
+	worker->generation = state->wave_generation;
+	if (pthread_create(&state->thread[state->num_workers], NULL,
+	run_worker, (void *) worker) != 0)
+	    break;
+	state->num_workers++;
+    }
+    state->wave_workers = min(state->num_workers,
+    min(state->threads, SYNC_MAX_THREADS) - 1);
+}
+/**********************************************************************/
+
+static void stop_workers(state)
+Syncstate *state;
+{
+    pthread_mutex_lock(&state->wave_mutex);
+    state->wave_quit = True;
+    pthread_cond_broadcast(&state->wave_start);
+    pthread_mutex_unlock(&state->wave_mutex);
+    while (state->num_workers > 0)
+	pthread_join(state->thread[--state->num_workers], NULL);
+}
+/**********************************************************************/
+
+/* Computes the diagonals of "path" that compute_path may need, from lo
+ * through hi, dividing them among the workers and this thread. */
+static void compute_wavefront(state, path, lo, hi)
+Syncstate *state;
+Path *path;
+long lo, hi;
+{
+    if (hi - lo + 1 > state->wave_size)
+    {
+	if (state->wave_size > 0)
+	    DISPOSE_ARRAY(state->wave_f);
+	state->wave_size = 2 * (hi - lo + 1);
+	state->wave_f = new_scratch(state->wave_size);
+    }
+    state->wave_path = path;
+    state->wave_lo = lo;
+    state->wave_hi = hi;
+    pthread_mutex_lock(&state->wave_mutex);
+    state->wave_generation++;
+    state->wave_pending = state->wave_workers;
+    pthread_cond_broadcast(&state->wave_start);
+    pthread_mutex_unlock(&state->wave_mutex);
+    compute_share(state, 0);
+    pthread_mutex_lock(&state->wave_mutex);
+    while (state->wave_pending > 0)
+	pthread_cond_wait(&state->wave_done, &state->wave_mutex);
+    pthread_mutex_unlock(&state->wave_mutex);
+}
+/**********************************************************************/
+
+/* Computes the furthest row reached on each diagonal of "path" with
+ * path->p edits, from those of path->prev. */
+static void compute_path(state, path)
+Syncstate *state;
+Path *path;
+{
+    long p = path->p, n_m = state->n_m, k, lo, hi;
+    state->diag_first = state->diag_last = state->diag_size / 2;
+    if (state->wave_workers > 0 && path->prev)
+    {
+	/* Only the diagonals within the bounds, and next to one of the
+	 * previous path, can be needed. */
+	lo = max(max(state->min_k, -p), path->prev->start_k - 1);
+	hi = min(min(state->max_k, p), path->prev->stop_k + 1);
+	if (hi - lo + 1 >= (state->wave_workers + 1) * MIN_WAVEFRONT_SHARE)
+	    compute_wavefront(state, path, lo, hi);
+    }
+    if (state->m <= state->n)
+    {
+	for (k = min(n_m, p); k >= max(state->min_k, -p); k--)
+	    compute_f(state, k, path);
+	for (k = n_m + 1; k <= min(state->max_k, p); k++)
+	    compute_f(state, k, path);
+    }
+    else
+    {
+	for (k = max(n_m, -p); k <= min(state->max_k, p); k++)
+	    compute_f(state, k, path);
+	for (k = n_m - 1; k >= max(state->min_k, -p); k--)
+	    compute_f(state, k, path);
+    }
+    state->wave_path = NULL;
+    path->f = NEW_ARRAY(state->diag_last - state->diag_first, F);
+    memcpy(path->f, state->diag_f + state->diag_first,
+    (state->diag_last - state->diag_first) * sizeof(F));
+}
+/**********************************************************************/
+
+static void start_pathlist(state, text)
+Syncstate *state;
+Text *text;
+{
+    match_widths(2, text);
+    state->a = text[0].value;
+    state->b = text[1].value;
+    state->snake = snake_table[text[0].width >> 1];
+    state->m = text[0].count;
+    state->n = text[1].count;
+    state->n_m = state->n - state->m;
+    state->min_k = -state->m;
+    state->max_k =  state->n;
+    if (state->diag_size == 0)
+    {
+	state->diag_size = MIN_DIAG_SIZE;
+	state->diag_f = new_scratch(state->diag_size);
+    }
+    start_workers(state);
+}
+/**********************************************************************/
+
+/* Computes every path until the end of the texts is reached, which takes
+ * more than "max_p" edits, or the paths take more than "max_size"
+ * bytes. */
+static short compute_pathlist(state, text, max_p, max_size)
+Syncstate *state;
+Text *text;
+long max_p;
+double max_size;
+{
+#ifdef SHOW_FASTUKK_REDUCTION
+    long ukkonen_count = 0, fastukk_count = 0, r, count;
+#endif
+    long p = -1;
+    double size = 0;
+    Path *path;
+    start_pathlist(state, text);
+    while (state->min_k <= state->n_m)
+    {
+	if (p == max_p)
+	    return(TOO_MANY_EDITS);
+	if (size > max_size)
+	    return(TOO_LARGE);
+	path = NEW(Path);
 	path->p = ++p;
-	list_insert_last(&pathlist, path);
-	if (m <= n)
-	{
-	    for (k = min(n_m, p); k >= max(min_k, -p); k--)
-		compute_f(k, path);
-	    for (k = n_m + 1; k <= min(max_k, p); k++)
-		compute_f(k, path);
-	}
-	else
-	{
-	    for (k = max(n_m, -p); k <= min(max_k, p); k++)
-		compute_f(k, path);
-	    for (k = n_m - 1; k >= max(min_k, -p); k--)
-		compute_f(k, path);
-	}
+	list_insert_last(&state->pathlist, path);
+	compute_path(state, path);
+	size += (double) (path->stop_k - path->start_k + 1) * sizeof(F);
 #ifdef SHOW_FASTUKK_REDUCTION
-	r = p - min(m, n);
-	count = min(-1, -r) - max(-m, -p) + 1;
+	r = p - min(state->m, state->n);
+	count = min(-1, -r) - max(-state->m, -p) + 1;
 	if (count > 0)
 	    ukkonen_count += count;
-	count = min(n, p) - max(0, r) + 1;
+	count = min(state->n, p) - max(0, r) + 1;
 	if (count > 0)
 	    ukkonen_count += count;
-	fastukk_count += diaglist.count;
+	fastukk_count += path->stop_k - path->start_k + 1;
 #endif
-	path->f = NEW_ARRAY(diaglist.count, F);
-	i = 0;
-	while (diaglist.first)
-	{
-	    diag = diaglist.first;
-	    list_remove(&diaglist, diag);
-	    path->f[i++] = diag->f;
-	    free(diag);
-	}
     }
 #ifdef SHOW_FASTUKK_REDUCTION
     fprintf(stderr, "%8d - %8d = %8d; %5.1f%% reduction\n",
     ukkonen_count, fastukk_count, ukkonen_count - fastukk_count,
     100.0 * (ukkonen_count - fastukk_count) / ukkonen_count);
 #endif
+    return(COMPLETE);
 }
 /**********************************************************************/
 
-static void obtain_matches(synclist)
-Synclist *synclist;
+static void dispose_path(path)
+Path *path;
+{
+    DISPOSE_ARRAY(path->f);
+    DISPOSE(path, Path);
+}
+/**********************************************************************/
+
+/* Saves the match made by the snake of "path" on diagonal k, and returns
+ * the diagonal of the previous path from which the snake starts. */
+static long trace_path(array, path, k)
+Syncarray *array;
+Path *path;
+long k;
+{
+    long f, start[2], prev_k = 0;
+    f = path->f[k - path->start_k];
+    start[0] = initial_f(k, path->prev, &prev_k);
+    if (f > start[0])
+    {
+	start[1] = start[0] + k;
+	add_match(array, start, f - start[0]);
+    }
+    return(prev_k);
+}
+/**********************************************************************/
+
+/* Saves the matches of the paths, tracing back from diagonal k of the
+ * last, and empties the list; the paths are released with their arena. */
+static void obtain_matches(state, array, k)
+Syncstate *state;
+Syncarray *array;
+long k;
+{
+    Path *path;
+    for (path = state->pathlist.last; path; path = path->prev)
+	k = trace_path(array, path, k);
+    list_initialize(&state->pathlist);
+}
+/**********************************************************************/
+
+static Path *next_path(state, prev)
+Syncstate *state;
+Path *prev;
 {
-    long k, f, start[2], prev_k;
     Path *path;
-    k = n_m;
-    while (pathlist.last)
+    path = NEW(Path);
+    path->p = prev->p + 1;
+    path->prev = prev;
+    compute_path(state, path);
+    return(path);
+}
+/**********************************************************************/
+
+/* Saves the matches of the paths after "first" up to the one with
+ * "last_p" edits, tracing back from diagonal k of that path, and returns
+ * the diagonal of "first" that is reached.  "first_min_k" and
+ * "first_max_k" are the bounds that held after "first" was computed.
+ * The paths are recomputed from "first"; if they would take more than
+ * "max_size" bytes, the path halfway is computed without keeping those
+ * before it, and each half is traced in turn, the later one first. */
+static long trace_segment(state, array, first, first_min_k, first_max_k,
+last_p, k, max_size)
+Syncstate *state;
+Syncarray *array;
+Path *first;
+long first_min_k, first_max_k, last_p, k;
+double max_size;
+{
+    long length, middle_p, middle_min_k, middle_max_k;
+    Path *path, *prev;
+    state->min_k = first_min_k;
+    state->max_k = first_max_k;
+    length = last_p - first->p;
+    if (length <= 1 || (double) length * (first->stop_k - first->start_k + 1 +
+    2 * length) * sizeof(F) <= max_size)
     {
-	path = pathlist.last;
-	f = path->f[k - path->start_k];
-	start[0] = initial_f(k, path->prev, &prev_k);
-	if (f > start[0])
+	for (path = first; path->p < last_p; path = next_path(state, path));
+	while (path != first)
 	{
-	    start[1] = start[0] + k;
-	    save_match(synclist, 2, synclist->first, start, f - start[0],
-	    NEW(long));
+	    k = trace_path(array, path, k);
+	    prev = path->prev;
+	    dispose_path(path);
+	    path = prev;
 	}
-	list_remove(&pathlist, path);
-	free(path->f);
-	free(path);
-	k = prev_k;
+	return(k);
+    }
+    middle_p = first->p + length / 2;
+    for (path = first; path->p < middle_p; )
+    {
+	prev = path;
+	path = next_path(state, prev);
+	if (prev != first)
+	    dispose_path(prev);
     }
+    path->prev = NULL;
+    middle_min_k = state->min_k;
+    middle_max_k = state->max_k;
+    k = trace_segment(state, array, path, middle_min_k, middle_max_k,
+    last_p, k, max_size);
+    dispose_path(path);
+    return(trace_segment(state, array, first, first_min_k, first_max_k,
+    middle_p, k, max_size));
 }
 /**********************************************************************/
 
-void fastukk_sync(synclist, text)
-Synclist *synclist;
+/* Finds the same matches as "compute_pathlist" and "obtain_matches", but
+ * keeps only a few paths at a time, recomputing the others as needed;
+ * at most "max_size" bytes of paths are kept at once beyond one path for
+ * each level of the recursion, at the cost of a few more passes over
+ * them.  Returns False, finding no matches, if more than "max_p" edits
+ * are needed, unless "max_p" is negative. */
+static Boolean linear_space_matches(state, array, text, max_p, max_size)
+Syncstate *state;
+Syncarray *array;
+Text *text;
+long max_p;
+double max_size;
+{
+    long first_min_k, first_max_k, last_p, k;
+    Path *first, *path, *prev;
+    start_pathlist(state, text);
+    first = NEW(Path);
+    compute_path(state, first);
+    first_min_k = state->min_k;
+    first_max_k = state->max_k;
+    /* The number of edits is found first, keeping only the latest path. */
+    for (path = first; state->min_k <= state->n_m; )
+    {
+	if (path->p == max_p)
+	{
+	    if (path != first)
+		dispose_path(path);
+	    dispose_path(first);
+	    return(False);
+	}
+	prev = path;
+	path = next_path(state, prev);
+	if (prev != first)
+	    dispose_path(prev);
+    }
+    last_p = path->p;
+    if (path != first)
+	dispose_path(path);
+    k = trace_segment(state, array, first, first_min_k, first_max_k,
+    last_p, state->n_m, max_size);
+    trace_path(array, first, k);
+    dispose_path(first);
+    return(True);
+}
+/**********************************************************************/
+
+static void save_found(array, start1, start2, length)
+Syncarray *array;
+long start1, start2, length;
+{
+    long start[2];
+    start[0] = start1;
+    start[1] = start2;
+    add_match(array, start, length);
+}
+/**********************************************************************/
+
+/* Returns the number of edits beyond which Ukkonen's algorithm is given up
+ * for the bit-parallel one, or -1 to use the bit-parallel one at once. */
+static long max_edits(text, method)
+Text *text;
+short method;
+{
+    long limit;
+    if (method == SYNC_BIT_PARALLEL)
+	return(-1);
+    if (method == SYNC_DIAGONAL || method == SYNC_LINEAR_SPACE ||
+    text[0].count == 0 || text[1].count == 0 ||
+    bit_parallel_size(text) > MAX_BIT_PARALLEL_SIZE)
+	return(MAX_F);
+    limit = (long) sqrt((double) text[0].count * text[1].count /
+    (64 * DIAGONAL_COST));
+    return(estimate_distance(text) > limit ? -1 : limit);
+}
+/**********************************************************************/
+
+/* Aligns the two texts optimally by the given method, which is not
+ * SYNC_ANCHORED, with the state of "context", adding the matches to
+ * "array" from last to first.  If "max_p" is not
+ * negative, only Ukkonen's algorithm is used, and False is returned,
+ * with no matches found, once more than "max_p" edits are known to be
+ * needed. */
+static Boolean optimal_sync(context, array, text, method, max_p)
+Synccontext *context;
+Syncarray *array;
+Text *text;
+short method;
+long max_p;
+{
+    Syncstate *state = context->state;
+    Arena *arena, *previous;
+    short status = TOO_MANY_EDITS;
+    long limit;
+    if (max_p >= 0)
+    {
+	/* Each edit changes the difference in length by at most one. */
+	if (labs(text[1].count - text[0].count) > max_p ||
+	estimate_distance(text) > max_p)
+	    return(False);
+	limit = max_p;
+    }
+    else
+	limit = max_edits(text, method);
+    if (limit >= 0)
+    {
+	if (text[0].count > MAX_F)
+	    error("text stream is too long");
+	if (method == SYNC_LINEAR_SPACE)
+	    status = TOO_LARGE;
+	else
+	{
+	    /* The paths are taken from an arena of their own, so that they
+	     * are released at once, while the matches are taken from the
+	     * caller's. */
+	    arena = new_arena();
+	    previous = use_arena(arena);
+	    status = compute_pathlist(state, text, limit, MAX_PATHLIST_SIZE);
+	    use_arena(previous);
+	    if (status == COMPLETE)
+		obtain_matches(state, array, state->n_m);
+	    else
+		list_initialize(&state->pathlist);
+	    free_arena(arena);
+	}
+	if (status == TOO_LARGE)
+	    status = (linear_space_matches(state, array, text, max_p,
+	    (method == SYNC_LINEAR_SPACE ? 0 : MAX_PATHLIST_SIZE)) ?
+	    COMPLETE : TOO_MANY_EDITS);
+    }
+    if (status == TOO_MANY_EDITS)
+    {
+	if (max_p >= 0)
+	    return(False);
+	/* The streams differ by too much for Ukkonen's algorithm. */
+	bit_parallel_sync(text, save_found, (void *) array);
+    }
+    return(True);
+}
+/**********************************************************************/
+
+/* Returns the address of character i of "text". */
+static void *text_address(text, i)
 Text *text;
+long i;
+{
+    return((char *) text->value.any + i * text->width);
+}
+/**********************************************************************/
+
+/* Puts in hash[i - start] a hash code of the ANCHOR_LENGTH characters of
+ * "text" starting at i, for each i from "start" to "stop" -
+ * ANCHOR_LENGTH; the code is zero if they include a reject character,
+ * and never zero otherwise. */
+static void hash_windows(text, start, stop, hash)
+Text *text;
+long start, stop;
+uint64_t *hash;
+{
+    uint64_t code = 0, power = 1;
+    long i, reject = start - 1;
+    Charvalue value;
+    for (i = 0; i < ANCHOR_LENGTH; i++)
+	power *= ANCHOR_BASE;
+    for (i = start; i < stop; i++)
+    {
+	value = TEXT_VALUE(text, i);
+	if (value == REJECT_CHARACTER)
+	    reject = i;
+	code = code * ANCHOR_BASE + value;
+	if (i - start >= ANCHOR_LENGTH)
+	    code -= power * TEXT_VALUE(text, i - ANCHOR_LENGTH);
+	if (i - start >= ANCHOR_LENGTH - 1)
+	    hash[i - start - ANCHOR_LENGTH + 1] = (reject > i - ANCHOR_LENGTH ?
+	    0 : code == 0 ? 1 : code);
+    }
+}
+/**********************************************************************/
+
+/* Returns the entry of "table" for "hash", adding it if "add" is True, or
+ * NULL if it is not there. */
+static Kmer *find_kmer(table, mask, hash, add)
+Kmer *table;
+unsigned long mask;
+uint64_t hash;
+Boolean add;
+{
+    unsigned long i = (unsigned long) (hash ^ (hash >> 29)) & mask;
+    while (table[i].hash != 0 && table[i].hash != hash)
+	i = (i + 1) & mask;
+    if (table[i].hash == 0)
+    {
+	if (!add)
+	    return(NULL);
+	table[i].hash = hash;
+    }
+    return(&table[i]);
+}
+/**********************************************************************/
+
+/* Puts in "chain" the indices of the longest increasing subsequence of
+ * the "count" positions, found by patience sorting, and returns its
+ * length. */
+static long longest_chain(position, count, chain)
+long *position, count, *chain;
+{
+    long *tail, *prev, length = 0, i, low, high, middle;
+    tail = NEW_ARRAY(count + 1, long);
+    prev = NEW_ARRAY(count + 1, long);
+    for (i = 0; i < count; i++)
+    {
+	low = 0;
+	high = length;
+	while (low < high)
+	{
+	    middle = (low + high) / 2;
+	    if (position[tail[middle]] < position[i])
+		low = middle + 1;
+	    else
+		high = middle;
+	}
+	prev[i] = (low > 0 ? tail[low - 1] : -1);
+	tail[low] = i;
+	if (low == length)
+	    length++;
+    }
+    for (i = (length > 0 ? tail[length - 1] : -1), middle = length; i >= 0;
+    i = prev[i])
+	chain[--middle] = i;
+    DISPOSE_ARRAY(prev);
+    DISPOSE_ARRAY(tail);
+    return(length);
+}
+/**********************************************************************/
+
+/* Finds the windows of ANCHOR_LENGTH characters occurring exactly once
+ * in both texts between start[i] and stop[i], and puts the longest
+ * chain of them in increasing order in both texts in "anchor", returning
+ * its length. */
+static long find_anchors(text, start, stop, anchor)
+Text *text;
+long *start, *stop;
+Segment *anchor;
+{
+    long count[2], num_found = 0, length, i, *found[2], *chain;
+    uint64_t *hash[2];
+    unsigned long size;
+    Kmer *table, *kmer;
+    for (i = 0; i < 2; i++)
+    {
+	count[i] = stop[i] - start[i] - ANCHOR_LENGTH + 1;
+	if (count[i] <= 0)
+	    return(0);
+	hash[i] = NEW_ARRAY(count[i], uint64_t);
+	hash_windows(&text[i], start[i], stop[i], hash[i]);
+    }
+    for (size = 1; size < 2 * (unsigned long) count[0]; size *= 2);
+    table = NEW_ARRAY(size, Kmer);
+    for (i = 0; i < count[0]; i++)
+	if (hash[0][i] != 0)
+	{
+	    kmer = find_kmer(table, size - 1, hash[0][i], True);
+	    kmer->count[0]++;
+	    kmer->start[0] = start[0] + i;
+	}
+    for (i = 0; i < count[1]; i++)
+	if (hash[1][i] != 0 &&
+	(kmer = find_kmer(table, size - 1, hash[1][i], False)))
+	{
+	    kmer->count[1]++;
+	    kmer->start[1] = start[1] + i;
+	}
+    /* The unique windows, in order in the first text, are chained by
+     * patience sorting on their position in the second. */
+    found[0] = NEW_ARRAY(count[0], long);
+    found[1] = NEW_ARRAY(count[0], long);
+    for (i = 0; i < count[0]; i++)
+	if (hash[0][i] != 0)
+	{
+	    kmer = find_kmer(table, size - 1, hash[0][i], False);
+	    if (kmer->count[0] == 1 && kmer->count[1] == 1 &&
+	    match_length(text[0].width, text_address(&text[0], kmer->start[0]),
+	    text_address(&text[1], kmer->start[1]), (long) ANCHOR_LENGTH,
+	    REJECT_CHARACTER) == ANCHOR_LENGTH)
+	    {
+		found[0][num_found] = kmer->start[0];
+		found[1][num_found++] = kmer->start[1];
+	    }
+	}
+    chain = NEW_ARRAY(num_found + 1, long);
+    length = longest_chain(found[1], num_found, chain);
+    for (i = 0; i < length; i++)
+    {
+	anchor[i].start[0] = found[0][chain[i]];
+	anchor[i].start[1] = found[1][chain[i]];
+	anchor[i].length = ANCHOR_LENGTH;
+    }
+    DISPOSE_ARRAY(chain);
+    DISPOSE_ARRAY(found[1]);
+    DISPOSE_ARRAY(found[0]);
+    DISPOSE_ARRAY(table);
+    DISPOSE_ARRAY(hash[1]);
+    DISPOSE_ARRAY(hash[0]);
+    return(length);
+}
+/**********************************************************************/
+
+/* Returns the number of characters before start[0] and start[1] that
+ * are equal in the two texts, up to "limit". */
+static long match_backward(text, start, limit)
+Text *text;
+long *start, limit;
+{
+    long length = 0;
+    Charvalue value;
+    while (length < limit)
+    {
+	value = TEXT_VALUE(&text[0], start[0] - length - 1);
+	if (value != TEXT_VALUE(&text[1], start[1] - length - 1) ||
+	value == REJECT_CHARACTER)
+	    break;
+	length++;
+    }
+    return(length);
+}
+/**********************************************************************/
+
+/* Turns the chain of "num_anchor" anchors into matched segments, which
+ * are extended as far as the texts agree and merged where they meet,
+ * and returns the number of segments.  The first segment is the common
+ * prefix of the texts and the last one their common suffix, either of
+ * which may be empty. */
+static long find_segments(text, anchor, num_anchor, segment)
+Text *text;
+Segment *anchor, *segment;
+long num_anchor;
+{
+    long num_segment = 1, i, j, limit;
+    Segment *last, *next;
+    segment[0].start[0] = segment[0].start[1] = 0;
+    segment[0].length = match_length(text[0].width, text[0].value.any,
+    text[1].value.any, min(text[0].count, text[1].count), REJECT_CHARACTER);
+    limit = min(text[0].count, text[1].count) - segment[0].length;
+    anchor[num_anchor].start[0] = text[0].count;
+    anchor[num_anchor].start[1] = text[1].count;
+    anchor[num_anchor].length = match_backward(text, anchor[num_anchor].start,
+    limit);
+    anchor[num_anchor].start[0] -= anchor[num_anchor].length;
+    anchor[num_anchor].start[1] -= anchor[num_anchor].length;
+    for (i = 0; i <= num_anchor; i++)
+    {
+	last = &segment[num_segment - 1];
+	next = &anchor[i];
+	/* Anchors overlapping the last segment are dropped. */
+	if (next->start[0] < last->start[0] + last->length ||
+	next->start[1] < last->start[1] + last->length)
+	{
+	    if (next->start[0] - next->start[1] == last->start[0] -
+	    last->start[1])
+		last->length = max(last->length, next->start[0] + next->length -
+		last->start[0]);
+	    continue;
+	}
+	limit = min(next->start[0] - last->start[0],
+	next->start[1] - last->start[1]) - last->length;
+	last->length += match_length(text[0].width,
+	text_address(&text[0], last->start[0] + last->length),
+	text_address(&text[1], last->start[1] + last->length), limit,
+	REJECT_CHARACTER);
+	limit = min(next->start[0] - last->start[0],
+	next->start[1] - last->start[1]) - last->length;
+	j = match_backward(text, next->start, limit);
+	if (j == limit && next->start[0] - last->start[0] == next->start[1] -
+	last->start[1])
+	    last->length = next->start[0] + next->length - last->start[0];
+	else
+	{
+	    segment[num_segment] = *next;
+	    segment[num_segment].start[0] -= j;
+	    segment[num_segment].start[1] -= j;
+	    segment[num_segment++].length += j;
+	}
+    }
+    return(num_segment);
+}
+/**********************************************************************/
+
+/* Aligns the gap optimally with the state of "context". */
+static void sync_gap(context, text, gap)
+Synccontext *context;
+Text *text;
+Gap *gap;
+{
+    Text view[2];
+    short i;
+    initialize_syncarray(&gap->matches, 2);
+    if (gap->stop[0] == gap->start[0] || gap->stop[1] == gap->start[1])
+	return;
+    for (i = 0; i < 2; i++)
+    {
+	view[i] = text[i];
+	view[i].value.any = text_address(&text[i], gap->start[i]);
+	view[i].count = view[i].size = gap->stop[i] - gap->start[i];
+	view[i].suspect = NULL;
+    }
+    optimal_sync(context, &gap->matches, view, SYNC_AUTOMATIC, -1L);
+}
+/**********************************************************************/
+
+/* Aligns the gaps of "gaplist" in turn until none is left. */
+static void sync_gaps(context, gaplist)
+Synccontext *context;
+Gaplist *gaplist;
+{
+    long i;
+    for (;;)
+    {
+	pthread_mutex_lock(&gaplist->mutex);
+	i = gaplist->next_gap++;
+	pthread_mutex_unlock(&gaplist->mutex);
+	if (i >= gaplist->num_gap)
+	    break;
+	sync_gap(context, gaplist->text, &gaplist->gap[i]);
+    }
+}
+/**********************************************************************/
+
+static void *run_gap_worker(argument)
+void *argument;
+{
+    Synccontext context;
+    initialize_synccontext(&context);
+    sync_gaps(&context, (Gaplist *) argument);
+    free_synccontext(&context);
+    return(NULL);
+}
+/**********************************************************************/
+
+/* Aligns the gaps of "gaplist", dividing them among up to
+ * context->threads threads; each gap is aligned by one thread, with
+ * Ukkonen's algorithm undivided. */
+static void sync_gaplist(context, gaplist)
+Synccontext *context;
+Gaplist *gaplist;
+{
+    pthread_t thread[SYNC_MAX_THREADS];
+    short num_threads = 0, threads, i;
+    threads = context->state->threads;
+    context->state->threads = 1;
+    gaplist->next_gap = 0;
+    pthread_mutex_init(&gaplist->mutex, NULL);
+    while (num_threads < min(threads, SYNC_MAX_THREADS) - 1 &&
+    num_threads < gaplist->num_gap - 1 &&
+    pthread_create(&thread[num_threads], NULL, run_gap_worker,
+    (void *) gaplist) == 0)
+	num_threads++;
+    sync_gaps(context, gaplist);
+    for (i = 0; i < num_threads; i++)
+	pthread_join(thread[i], NULL);
+    pthread_mutex_destroy(&gaplist->mutex);
+    context->state->threads = threads;
+}
+/**********************************************************************/
+
+/* Saves the matches of the alignment of "gap", which are from last to
+ * first and lie before every match saved so far, and disposes of them. */
+static void save_gap(array, gap)
+Syncarray *array;
+Gap *gap;
 {
+    long start[2], k;
+    short i;
+    for (k = 0; k < gap->matches.count; k++)
+    {
+	for (i = 0; i < 2; i++)
+	    start[i] = gap->start[i] + gap->matches.start[i][k];
+	add_match(array, start, gap->matches.length[0][k]);
+    }
+    free_syncarray(&gap->matches);
+}
+/**********************************************************************/
+
+/* Returns the number of characters of the snake by which "path" reaches
+ * its furthest point on diagonal k. */
+static long final_snake(path, k)
+Path *path;
+long k;
+{
+    long prev_k;
+    return((long) path->f[k - path->start_k] - initial_f(k, path->prev,
+    &prev_k));
+}
+/**********************************************************************/
+
+/* Returns the path, up to "last", whose furthest point on some diagonal
+ * has passed the most characters of both texts together, among those
+ * reached by a snake of at least MIN_COMMIT_SNAKE characters, and sets
+ * "best_k" to that diagonal; returns NULL if there are none. */
+static Path *best_point(last, best_k)
+Path *last;
+long *best_k;
+{
+    Path *path, *best = NULL;
+    long k, progress, best_progress = -1;
+    for (path = last; path; path = path->prev)
+	for (k = path->start_k; k <= path->stop_k; k++)
+	{
+	    progress = 2 * (long) path->f[k - path->start_k] + k;
+	    if (progress > best_progress &&
+	    final_snake(path, k) >= MIN_COMMIT_SNAKE)
+	    {
+		best_progress = progress;
+		best = path;
+		*best_k = k;
+	    }
+	}
+    return(best);
+}
+/**********************************************************************/
+
+/* Returns the diagonal of "path" on which its furthest point has passed
+ * the most characters of both texts together. */
+static long best_diagonal(path)
+Path *path;
+{
+    long k, best_k = path->start_k, progress, best = -1;
+    for (k = path->start_k; k <= path->stop_k; k++)
+    {
+	progress = 2 * (long) path->f[k - path->start_k] + k;
+	if (progress > best)
+	{
+	    best = progress;
+	    best_k = k;
+	}
+    }
+    return(best_k);
+}
+/**********************************************************************/
+
+/* Aligns the texts by Ukkonen's algorithm in rounds of at most
+ * context->max_cost edits each, so that the work is bounded by the length
+ * of the texts times that cost.  A round that cannot reach the end of the
+ * texts commits to the alignment of its furthest point that ends in a
+ * long snake, or of its furthest point if none does even with a greater
+ * cost, and the next round starts there.  context->excess is set to a bound on the number of
+ * edits by which the alignment may exceed an optimal one. */
+static void approximate_sync(context, array, text)
+Synccontext *context;
+Syncarray *array;
+Text *text;
+{
+    Syncstate *state = context->state;
+    Arena *arena, *previous;
+    Gap *round, *old_round, *gap;
+    Path *path;
+    Text view[2];
+    long num_round = 0, size = 16, start[2], stop[2], cost, round_cost, lower,
+    edits = 0, k, i;
+    short status, j;
+    Boolean exact;
     if (text[0].count > MAX_F)
 	error("text stream is too long");
-    initialize_synclist(synclist, 2, text);
-    compute_pathlist(text);
-    obtain_matches(synclist);
-    number_matches(synclist);
+    cost = max(context->max_cost, 1);
+    /* Each edit changes the difference in length by at most one. */
+    lower = max(labs(text[1].count - text[0].count), estimate_distance(text));
+    round = NEW_ARRAY(size, Gap);
+    start[0] = start[1] = 0;
+    do
+    {
+	if (num_round == size)
+	{
+	    old_round = round;
+	    round = NEW_ARRAY(2 * size, Gap);
+	    memcpy(round, old_round, size * sizeof(Gap));
+	    DISPOSE_ARRAY(old_round);
+	    size *= 2;
+	}
+	gap = &round[num_round++];
+	for (j = 0; j < 2; j++)
+	{
+	    gap->start[j] = start[j];
+	    view[j] = text[j];
+	    view[j].value.any = text_address(&text[j], start[j]);
+	    view[j].count = view[j].size = text[j].count - start[j];
+	    view[j].suspect = NULL;
+	}
+	initialize_syncarray(&gap->matches, 2);
+	for (round_cost = cost; ; round_cost *= 2)
+	{
+	    arena = new_arena();
+	    previous = use_arena(arena);
+	    status = compute_pathlist(state, view, round_cost,
+	    MAX_PATHLIST_SIZE);
+	    use_arena(previous);
+	    if (status == COMPLETE)
+	    {
+		path = state->pathlist.last;
+		k = state->n_m;
+		break;
+	    }
+	    /* The end is more edits away than the last path has. */
+	    if (num_round == 1)
+		lower = max(lower, state->pathlist.last->p + 1);
+	    if ((path = best_point(state->pathlist.last, &k)) ||
+	    status == TOO_LARGE || round_cost / MAX_ROUND_GROWTH >= cost)
+		break;
+	    /* The round started within a long run of edits, and a chance
+	     * match beyond it would mislead the next one. */
+	    list_initialize(&state->pathlist);
+	    free_arena(arena);
+	}
+	if (!path)
+	{
+	    path = state->pathlist.last;
+	    k = best_diagonal(path);
+	}
+	/* The paths after the one committed to are left to the arena. */
+	while (state->pathlist.last != path)
+	    list_remove(&state->pathlist, state->pathlist.last);
+	i = path->f[k - path->start_k];
+	obtain_matches(state, &gap->matches, k);
+	free_arena(arena);
+	start[0] += i;
+	start[1] += i + k;
+    }
+    while (status != COMPLETE);
+    /* A single round is an optimal alignment. */
+    exact = (num_round == 1);
+    while (num_round > 0)
+	save_gap(array, &round[--num_round]);
+    DISPOSE_ARRAY(round);
+    /* Each run of unmatched characters, between the matches from last to
+     * first, takes as many edits as it has characters of the longer text. */
+    stop[0] = text[0].count;
+    stop[1] = text[1].count;
+    for (k = 0; k <= array->count; k++)
+    {
+	for (j = 0; j < 2; j++)
+	    start[j] = (k < array->count ? array->stop[j][k] + 1 : 0);
+	edits += max(stop[0] - start[0], stop[1] - start[1]);
+	if (k < array->count)
+	    for (j = 0; j < 2; j++)
+		stop[j] = array->start[j][k];
+    }
+    context->excess = (exact ? 0 : edits - lower);
+}
+/**********************************************************************/
+
+/* Saves the "num_segment" segments as matches, and the matches of an
+ * optimal alignment of each gap between them and after the last; the
+ * first segment starts both texts. */
+static void sync_segments(context, array, text, segment, num_segment)
+Synccontext *context;
+Syncarray *array;
+Text *text;
+Segment *segment;
+long num_segment;
+{
+    Gaplist gaplist;
+    Gap *gap;
+    long i;
+    short j;
+    /* Gap i lies after segment i, up to the next one or the end. */
+    gaplist.text = text;
+    gaplist.num_gap = num_segment;
+    gaplist.gap = NEW_ARRAY(num_segment, Gap);
+    for (i = 0; i < num_segment; i++)
+    {
+	gap = &gaplist.gap[i];
+	for (j = 0; j < 2; j++)
+	{
+	    gap->start[j] = segment[i].start[j] + segment[i].length;
+	    gap->stop[j] = (i + 1 < num_segment ? segment[i + 1].start[j] :
+	    text[j].count);
+	}
+    }
+    sync_gaplist(context, &gaplist);
+    context->anchor_coverage = 0;
+    for (i = num_segment - 1; i >= 0; i--)
+    {
+	save_gap(array, &gaplist.gap[i]);
+	if (segment[i].length > 0)
+	{
+	    add_match(array, segment[i].start, segment[i].length);
+	    context->anchor_coverage += segment[i].length;
+	}
+    }
+    DISPOSE_ARRAY(gaplist.gap);
+}
+/**********************************************************************/
+
+/* Aligns the texts by matching their common prefix and suffix and a chain
+ * of anchors, and aligning only the gaps between these optimally; if the
+ * segments matched are too sparse to be trusted, the whole texts are
+ * aligned optimally, and context->anchor_coverage is 0. */
+static void anchored_sync(context, array, text)
+Synccontext *context;
+Syncarray *array;
+Text *text;
+{
+    Segment *anchor, *segment;
+    long num_anchor, num_segment, start[2], stop[2], limit, coverage = 0, i;
+    limit = min(text[0].count, text[1].count);
+    anchor = NEW_ARRAY(limit + 2, Segment);
+    segment = NEW_ARRAY(limit + 2, Segment);
+    start[0] = start[1] = 0;
+    stop[0] = text[0].count;
+    stop[1] = text[1].count;
+    num_anchor = find_anchors(text, start, stop, anchor);
+    num_segment = find_segments(text, anchor, num_anchor, segment);
+    for (i = 0; i < num_segment; i++)
+	coverage += segment[i].length;
+    if (coverage >= MIN_ANCHOR_COVERAGE * limit)
+	sync_segments(context, array, text, segment, num_segment);
+    else
+    {
+	context->anchor_coverage = 0;
+	optimal_sync(context, array, text, SYNC_AUTOMATIC, -1L);
+    }
+    DISPOSE_ARRAY(segment);
+    DISPOSE_ARRAY(anchor);
+}
+/**********************************************************************/
+
+/* Puts the lines of "text" in "line", and returns their number. */
+static long find_lines(text, line)
+Text *text;
+Line *line;
+{
+    long num_line = 0, i;
+    uint64_t code = 0;
+    Charvalue value;
+    Boolean reject = False;
+    for (i = 0; i < text->count; i++)
+    {
+	value = TEXT_VALUE(text, i);
+	if (value == REJECT_CHARACTER)
+	    reject = True;
+	code = code * ANCHOR_BASE + value;
+	if (value == NEWLINE || i == text->count - 1)
+	{
+	    line[num_line].start = (num_line > 0 ? line[num_line - 1].start +
+	    line[num_line - 1].length : 0);
+	    line[num_line].length = i + 1 - line[num_line].start;
+	    line[num_line++].hash = (reject ? 0 : code == 0 ? 1 : code);
+	    code = 0;
+	    reject = False;
+	}
+    }
+    return(num_line);
+}
+/**********************************************************************/
+
+/* Returns True if line i of the first text and line j of the second are
+ * equal, and have no reject character. */
+static Boolean same_line(diff, i, j)
+Linediff *diff;
+long i, j;
+{
+    Line *line1 = &diff->line[0][i], *line2 = &diff->line[1][j];
+    return(line1->hash != 0 && line1->hash == line2->hash &&
+    line1->length == line2->length &&
+    match_length(diff->text[0].width, text_address(&diff->text[0],
+    line1->start), text_address(&diff->text[1], line2->start), line1->length,
+    REJECT_CHARACTER) == line1->length);
+}
+/**********************************************************************/
+
+static void add_pair(diff, i, j)
+Linediff *diff;
+long i, j;
+{
+    diff->pair[0][diff->num_pair] = i;
+    diff->pair[1][diff->num_pair++] = j;
+}
+/**********************************************************************/
+
+/* Matches lines lo[i] through hi[i] - 1 of each text by patience diff:
+ * the common leading and trailing lines are matched, and then the longest
+ * chain of lines occurring once in each, with the lines between the links
+ * of the chain matched in the same way. */
+static void diff_lines(diff, lo, hi)
+Linediff *diff;
+long *lo, *hi;
+{
+    long next_lo[2], next_hi[2], suffix, count, num_found, length, i;
+    long *found[2], *chain;
+    unsigned long size;
+    Kmer *table, *kmer;
+    Line *line;
+    while (lo[0] < hi[0] && lo[1] < hi[1] && same_line(diff, lo[0], lo[1]))
+	add_pair(diff, lo[0]++, lo[1]++);
+    for (suffix = 0; lo[0] < hi[0] - suffix && lo[1] < hi[1] - suffix &&
+    same_line(diff, hi[0] - suffix - 1, hi[1] - suffix - 1); suffix++);
+    hi[0] -= suffix;
+    hi[1] -= suffix;
+    if (lo[0] < hi[0] && lo[1] < hi[1])
+    {
+	count = hi[0] - lo[0];
+	for (size = 1; size < 2 * (unsigned long) count; size *= 2);
+	table = NEW_ARRAY(size, Kmer);
+	for (i = lo[0]; i < hi[0]; i++)
+	    if ((line = &diff->line[0][i])->hash != 0)
+	    {
+		kmer = find_kmer(table, size - 1, line->hash, True);
+		kmer->count[0]++;
+		kmer->start[0] = i;
+	    }
+	for (i = lo[1]; i < hi[1]; i++)
+	    if ((line = &diff->line[1][i])->hash != 0 &&
+	    (kmer = find_kmer(table, size - 1, line->hash, False)))
+	    {
+		kmer->count[1]++;
+		kmer->start[1] = i;
+	    }
+	found[0] = NEW_ARRAY(count, long);
+	found[1] = NEW_ARRAY(count, long);
+	num_found = 0;
+	for (i = lo[0]; i < hi[0]; i++)
+	    if ((line = &diff->line[0][i])->hash != 0)
+	    {
+		kmer = find_kmer(table, size - 1, line->hash, False);
+		if (kmer->count[0] == 1 && kmer->count[1] == 1 &&
+		same_line(diff, kmer->start[0], kmer->start[1]))
+		{
+		    found[0][num_found] = kmer->start[0];
+		    found[1][num_found++] = kmer->start[1];
+		}
+	    }
+	DISPOSE_ARRAY(table);
+	chain = NEW_ARRAY(num_found + 1, long);
+	length = longest_chain(found[1], num_found, chain);
+	for (i = 0; i < length; i++)
+	{
+	    next_lo[0] = lo[0];
+	    next_lo[1] = lo[1];
+	    next_hi[0] = found[0][chain[i]];
+	    next_hi[1] = found[1][chain[i]];
+	    diff_lines(diff, next_lo, next_hi);
+	    add_pair(diff, found[0][chain[i]], found[1][chain[i]]);
+	    lo[0] = found[0][chain[i]] + 1;
+	    lo[1] = found[1][chain[i]] + 1;
+	}
+	DISPOSE_ARRAY(chain);
+	DISPOSE_ARRAY(found[1]);
+	DISPOSE_ARRAY(found[0]);
+	if (length > 0)
+	    diff_lines(diff, lo, hi);
+    }
+    for (i = 0; i < suffix; i++)
+	add_pair(diff, hi[0] + i, hi[1] + i);
+}
+/**********************************************************************/
+
+/* Aligns the texts by matching identical lines, found by a line-level
+ * patience diff, and aligning only the blocks of changed lines between
+ * them optimally. */
+static void line_sync(context, array, text)
+Synccontext *context;
+Syncarray *array;
+Text *text;
+{
+    Linediff diff;
+    Segment *segment, *last;
+    long num_line[2], num_segment = 1, lo[2], hi[2], start[2], i;
+    short j;
+    diff.text = text;
+    for (j = 0; j < 2; j++)
+    {
+	diff.line[j] = NEW_ARRAY(text[j].count + 1, Line);
+	num_line[j] = find_lines(&text[j], diff.line[j]);
+	diff.pair[j] = NEW_ARRAY(min(text[0].count, text[1].count) + 1, long);
+	lo[j] = 0;
+	hi[j] = num_line[j];
+    }
+    diff.num_pair = 0;
+    diff_lines(&diff, lo, hi);
+    /* Runs of matched lines adjacent in both texts make one segment, and
+     * the first segment starts both texts, even if it is empty. */
+    segment = NEW_ARRAY(diff.num_pair + 1, Segment);
+    segment[0].start[0] = segment[0].start[1] = segment[0].length = 0;
+    for (i = 0; i < diff.num_pair; i++)
+    {
+	for (j = 0; j < 2; j++)
+	    start[j] = diff.line[j][diff.pair[j][i]].start;
+	last = &segment[num_segment - 1];
+	if (start[0] == last->start[0] + last->length &&
+	start[1] == last->start[1] + last->length)
+	    last->length += diff.line[0][diff.pair[0][i]].length;
+	else
+	{
+	    last = &segment[num_segment++];
+	    last->start[0] = start[0];
+	    last->start[1] = start[1];
+	    last->length = diff.line[0][diff.pair[0][i]].length;
+	}
+    }
+    sync_segments(context, array, text, segment, num_segment);
+    DISPOSE_ARRAY(segment);
+    for (j = 0; j < 2; j++)
+    {
+	DISPOSE_ARRAY(diff.pair[j]);
+	DISPOSE_ARRAY(diff.line[j]);
+    }
+}
+/**********************************************************************/
+
+void initialize_synccontext(context)
+Synccontext *context;
+{
+    Arena *previous;
+    Syncstate *state;
+    context->method = SYNC_AUTOMATIC;
+    context->threads = 1;
+    context->max_edits = -1;
+    context->max_cost = -1;
+    context->anchor_coverage = 0;
+    context->excess = 0;
+    previous = use_arena(NULL);
+    state = context->state = NEW(Syncstate);
+    use_arena(previous);
+    pthread_mutex_init(&state->wave_mutex, NULL);
+    pthread_cond_init(&state->wave_start, NULL);
+    pthread_cond_init(&state->wave_done, NULL);
+}
+/**********************************************************************/
+
+void free_synccontext(context)
+Synccontext *context;
+{
+    Syncstate *state = context->state;
+    if (state->diag_size > 0)
+	DISPOSE_ARRAY(state->diag_f);
+    if (state->wave_size > 0)
+	DISPOSE_ARRAY(state->wave_f);
+    stop_workers(state);
+    pthread_cond_destroy(&state->wave_done);
+    pthread_cond_destroy(&state->wave_start);
+    pthread_mutex_destroy(&state->wave_mutex);
+    DISPOSE(state, Syncstate);
+    context->state = NULL;
+}
+/**********************************************************************/
+
+Boolean context_array(context, array, text)
+Synccontext *context;
+Syncarray *array;
+Text *text;
+{
+    Boolean synchronized = True;
+    match_widths(2, text);
+    initialize_syncarray(array, 2);
+    context->state->threads = context->threads;
+    context->excess = 0;
+    if (context->method == SYNC_ANCHORED)
+	anchored_sync(context, array, text);
+    else if (context->method == SYNC_LINES)
+	line_sync(context, array, text);
+    else if (context->max_cost >= 0 && context->max_edits < 0)
+	approximate_sync(context, array, text);
+    else
+	synchronized = optimal_sync(context, array, text, context->method,
+	context->max_edits);
+    close_syncarray(array, text);
+    return(synchronized);
+}
+/**********************************************************************/
+
+Boolean context_sync(context, synclist, text)
+Synccontext *context;
+Synclist *synclist;
+Text *text;
+{
+    Syncarray array;
+    Boolean synchronized;
+    synchronized = context_array(context, &array, text);
+    make_synclist(synclist, &array);
+    free_syncarray(&array);
+    return(synchronized);
+}
+/**********************************************************************/
+
+Boolean fastukk_array(array, text)
+Syncarray *array;
+Text *text;
+{
+    static Synccontext context;
+    Boolean synchronized;
+    if (!context.state)
+	initialize_synccontext(&context);
+    context.method = fastukk_method;
+    context.threads = fastukk_threads;
+    context.max_edits = fastukk_max_edits;
+    context.max_cost = fastukk_max_cost;
+    synchronized = context_array(&context, array, text);
+    fastukk_anchor_coverage = context.anchor_coverage;
+    fastukk_excess = context.excess;
+    return(synchronized);
+}
+/**********************************************************************/
+
+Boolean fastukk_sync(synclist, text)
+Synclist *synclist;
+Text *text;
+{
+    Syncarray array;
+    Boolean synchronized;
+    synchronized = fastukk_array(&array, text);
+    make_synclist(synclist, &array);
+    free_syncarray(&array);
+    return(synchronized);
+}
+/**********************************************************************/
+
+/* Returns the text of "text" whose estimated distances to the others add
+ * up to the least, or the first such text. */
+static short choose_center(num_text, text)
+short num_text;
+Text *text;
+{
+    long total[SYNC_MAX_STREAMS], distance;
+    Text pair[2];
+    short center = 0, i, j;
+    for (i = 0; i < num_text; i++)
+	total[i] = 0;
+    for (i = 0; i < num_text; i++)
+	for (j = i + 1; j < num_text; j++)
+	{
+	    pair[0] = text[i];
+	    pair[1] = text[j];
+	    distance = estimate_distance(pair);
+	    total[i] += distance;
+	    total[j] += distance;
+	}
+    for (i = 1; i < num_text; i++)
+	if (total[i] < total[center])
+	    center = i;
+    return(center);
+}
+/**********************************************************************/
+
+/* Aligns the center of "star" with each other text in turn until none is
+ * left. */
+static void align_star(star)
+Star *star;
+{
+    Synccontext context;
+    Text pair[2];
+    short i;
+    initialize_synccontext(&context);
+    context.method = star->method;
+    context.threads = star->threads;
+    for (;;)
+    {
+	pthread_mutex_lock(&star->mutex);
+	i = star->next_text++;
+	pthread_mutex_unlock(&star->mutex);
+	if (i >= star->num_text)
+	    break;
+	if (i == star->center)
+	    continue;
+	pair[0] = star->text[star->center];
+	pair[1] = star->text[i];
+	context_array(&context, &star->pair[i], pair);
+    }
+    free_synccontext(&context);
+}
+/**********************************************************************/
+
+static void *run_star_worker(argument)
+void *argument;
+{
+    align_star((Star *) argument);
+    return(NULL);
+}
+/**********************************************************************/
+
+/* Merges the alignments of "star" into "array".  Characters of the center
+ * matched in every alignment are matched in all the texts.  A run of the
+ * center unmatched in any alignment is widened until it ends between the
+ * items of every alignment, and is left unmatched along with the
+ * characters of each text aligned with it. */
+static void merge_star(array, star)
+Syncarray *array;
+Star *star;
+{
+    Syncarray *pair;
+    long index[SYNC_MAX_STREAMS], start[SYNC_MAX_STREAMS],
+    stop[SYNC_MAX_STREAMS], position, end, length, match = 0, k;
+    short num_text = star->num_text, center = star->center, i;
+    Boolean remaining, matched, changed;
+    initialize_syncarray(array, num_text);
+    for (i = 0; i < num_text; i++)
+	index[i] = start[i] = 0;
+    for (;;)
+    {
+	/* Item index[i] of each alignment holds the center at "position",
+	 * or lies at "position" with none of the center. */
+	position = start[center];
+	matched = True;
+	remaining = (position < star->text[center].count);
+	for (i = 0; i < num_text; i++)
+	    if (i != center)
+	    {
+		pair = &star->pair[i];
+		if (index[i] < pair->count)
+		    remaining = True;
+		if (index[i] == pair->count || !pair->match[index[i]])
+		    matched = False;
+	    }
+	if (!remaining)
+	    break;
+	if (matched)
+	{
+	    length = star->text[center].count - position;
+	    for (i = 0; i < num_text; i++)
+		if (i != center)
+		    length = min(length,
+		    star->pair[i].stop[0][index[i]] + 1 - position);
+	    for (i = 0; i < num_text; i++)
+	    {
+		stop[i] = start[i] + length;
+		if (i != center &&
+		star->pair[i].stop[0][index[i]] < position + length)
+		    index[i]++;
+	    }
+	    add_item(array, start, stop, ++match);
+	}
+	else
+	{
+	    end = position;
+	    do
+	    {
+		changed = False;
+		for (i = 0; i < num_text; i++)
+		    if (i != center)
+		    {
+			pair = &star->pair[i];
+			for (k = index[i]; k < pair->count &&
+			(pair->start[0][k] < end ||
+			(pair->start[0][k] == end && !pair->match[k])); k++)
+			    if (!pair->match[k] && pair->stop[0][k] + 1 > end)
+			    {
+				end = pair->stop[0][k] + 1;
+				changed = True;
+			    }
+		    }
+	    }
+	    while (changed);
+	    for (i = 0; i < num_text; i++)
+	    {
+		if (i == center)
+		{
+		    stop[i] = end;
+		    continue;
+		}
+		pair = &star->pair[i];
+		for (k = index[i]; k < pair->count && pair->stop[0][k] < end;
+		k++);
+		index[i] = k;
+		/* The run may end within a match of this alignment. */
+		if (k < pair->count && pair->start[0][k] < end)
+		    stop[i] = pair->start[1][k] + end - pair->start[0][k];
+		else
+		    stop[i] = (k < pair->count ? pair->start[1][k] :
+		    star->text[i].count);
+	    }
+	    add_item(array, start, stop, 0L);
+	}
+	for (i = 0; i < num_text; i++)
+	    start[i] = stop[i];
+    }
+}
+/**********************************************************************/
+
+void center_sync(array, num_text, text, center)
+Syncarray *array;
+short num_text;
+Text *text;
+short center;
+{
+    Star star;
+    pthread_t thread[SYNC_MAX_THREADS];
+    short threads, workers, num_threads = 0, i;
+    if (num_text < MIN_STREAMS || num_text > SYNC_MAX_STREAMS)
+	error("invalid number of text streams");
+    match_widths(num_text, text);
+    if (center < 0 || center >= num_text)
+	center = choose_center(num_text, text);
+    star.text = text;
+    star.num_text = num_text;
+    star.center = center;
+    star.pair = NEW_ARRAY(num_text, Syncarray);
+    /* Threads beyond one per alignment divide the paths of each. */
+    threads = max(1, min(synchronize_threads, SYNC_MAX_THREADS));
+    workers = min(threads, num_text - 1);
+    star.method = fastukk_method;
+    star.threads = threads / workers;
+    star.next_text = 0;
+    pthread_mutex_init(&star.mutex, NULL);
+    while (num_threads < workers - 1 &&
+    pthread_create(&thread[num_threads], NULL, run_star_worker,
+    (void *) &star) == 0)
+	num_threads++;
+    align_star(&star);
+    for (i = 0; i < num_threads; i++)
+	pthread_join(thread[i], NULL);
+    pthread_mutex_destroy(&star.mutex);
+    merge_star(array, &star);
+    for (i = 0; i < num_text; i++)
+	free_syncarray(&star.pair[i]);
+    DISPOSE_ARRAY(star.pair);
 }
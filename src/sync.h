@@ -11,6 +11,12 @@
  *  finds an optimal match of two text streams using cost function
  *  (1,1,1).
  *
+ *  The results of "synchronize" and "fastukk_sync" are built in a
+ *  "Syncarray", which keeps the matched and unmatched substrings in
+ *  columns of one block of memory; "synchronize_array" and
+ *  "fastukk_array" return it as it is, and "synchronize" and
+ *  "fastukk_sync" copy it into a "Synclist".
+ *
  *  Author: Stephen V. Rice
  *  
  * Copyright 1996 The Board of Regents of the Nevada System of Higher
@@ -34,6 +40,7 @@
 #ifndef _SYNC_
 #define _SYNC_
 
+#include "list.h"
 #include "text.h"
 
 typedef
@@ -43,8 +50,8 @@ struct
     long stop;		/* index of the last character of the substring */
     long length;	/* length of the substring in characters */
 } Substr;		/* describes a substring of a text value by specifying
-			   its indices within the "array" representation of the
-			   text value */
+			   its indices within the array of character values
+			   of the text */
 
 BEGIN_ITEM(Sync)
     Substr *substr;	/* array describing one substring for each text value */
@@ -56,12 +63,88 @@ END_ITEM(Sync);
 BEGIN_LIST_OF(Sync)
 END_LIST(Synclist);	/* list of matched and unmatched substrings */
 
+#define SYNC_MAX_STREAMS  16
+
+typedef
+struct
+{
+    short num_text;	/* number of text streams */
+    long count;		/* number of items */
+    long size;		/* number of items for which there is room */
+    long *start[SYNC_MAX_STREAMS];
+    long *stop[SYNC_MAX_STREAMS];
+    long *length[SYNC_MAX_STREAMS];
+			/* columns describing the substring of each item for
+			   each text, as the fields of "Substr" */
+    long *match;	/* column of the match number of each item, or 0 if
+			   its substrings are unmatched */
+} Syncarray;		/* the items of a "Synclist", in order, kept as one
+			   block of memory with a column for each field; an
+			   empty array has "count" 0 and no block */
+
+typedef
+struct
+{
+    Syncarray *array;
+    long index;		/* the item described by "sync" */
+    Sync sync;
+    Substr substr[SYNC_MAX_STREAMS];
+    long match;
+} Syncview;		/* an iterator over the items of a "Syncarray",
+			   describing each in turn as a "Sync" of its own */
+
+Sync *first_sync(/* Syncview *view, Syncarray *array */);
+			/* starts "view" on "array", and returns a "Sync"
+			   describing its first item, or NULL if it is empty;
+			   the "Sync" belongs to "view", is overwritten by
+			   "next_sync", and has no neighbors in any list */
+
+Sync *next_sync(/* Syncview *view */);
+			/* returns a "Sync" describing the next item of the
+			   array of "view", or NULL after the last */
+
+void free_syncarray(/* Syncarray *array */);
+			/* releases the block of "array", leaving it empty */
+
+void synchronize_array(/* Syncarray *array, short num_text, Text *text */);
+			/* does what "synchronize" does, storing the results
+			   in "array" */
+
+Boolean fastukk_array(/* Syncarray *array, Text *text */);
+			/* does what "fastukk_sync" does, storing the results
+			   in "array" */
+
 void synchronize(/* Synclist *synclist, short num_text, Text *text */);
 			/* given "num_text" streams of text, synchronizes the
 			   streams and stores the results in "synclist"; each
 			   item in the list points to an array of "num_text"
 			   substrings */
 
+void center_sync(/* Syncarray *array, short num_text, Text *text,
+		      short center */);
+			/* given "num_text" streams of text, aligns each of
+			   them optimally with stream "center", in the manner
+			   of "fastukk_sync" with "fastukk_method", and merges
+			   these alignments into "array": the substrings of
+			   the center matched by every stream are matched,
+			   and the rest are unmatched along with what each
+			   stream aligns with them; if "center" is negative,
+			   the stream whose profile of adjacent character
+			   pairs is closest to those of the others is taken.
+			   The alignments are divided among up to
+			   "synchronize_threads" threads, and any threads
+			   beyond one for each divide the paths of each as
+			   "fastukk_threads" does */
+
+extern short synchronize_threads;
+			/* number of threads, from 1 (the default) to
+			   SYNC_MAX_THREADS, used by "synchronize" and
+			   "center_sync"; in "synchronize", the ranges
+			   on each side of a match are independent, and are
+			   queued for the threads, each taking its latest
+			   range or else stealing the oldest of another's, so
+			   the result is the same for any number of threads */
+
 void transpose_sync(/* Synclist *synclist1, Synclist *synclist2, 
 		       Text *text1, Text *text2 */);
 			/* synchronizes two streams of text while allowing for
@@ -69,10 +152,133 @@ void transpose_sync(/* Synclist *synclist1, Synclist *synclist2,
 			   stored in its own list, and each item of its list
 			   points to only a single substring */
 
-void fastukk_sync(/* Synclist *synclist, Text *text */);
+Boolean fastukk_sync(/* Synclist *synclist, Text *text */);
 			/* given two streams in the array "text", synchronizes
 			   them optimally and stores the results in "synclist";
 			   each item in the list points to an array of two
-			   substrings */
+			   substrings; returns False, leaving both streams
+			   unmatched, if they need more edits than
+			   "fastukk_max_edits" allows */
+
+#define SYNC_AUTOMATIC     0
+#define SYNC_DIAGONAL      1
+#define SYNC_BIT_PARALLEL  2
+#define SYNC_LINEAR_SPACE  3
+#define SYNC_ANCHORED      4
+#define SYNC_LINES         5
+
+extern short fastukk_method;
+			/* algorithm used by "fastukk_sync": SYNC_DIAGONAL for
+			   Ukkonen's algorithm, which extends one diagonal of
+			   the edit distance matrix at a time and is fastest
+			   when the streams are similar; SYNC_BIT_PARALLEL for
+			   the bit-parallel algorithm of "bitsync.h", which
+			   computes the whole matrix 64 rows at a time and is
+			   fastest when they are not; SYNC_LINEAR_SPACE for
+			   Ukkonen's algorithm recomputing its paths by divide
+			   and conquer rather than keeping them, which it also
+			   does by itself when they would take too much
+			   memory; or SYNC_AUTOMATIC (the default) to start
+			   with the first and switch to the second once the
+			   edit distance is known to be large.  All of them
+			   find the same alignment.  SYNC_ANCHORED is quicker
+			   for long, similar streams, but not always optimal:
+			   it matches their common prefix and suffix and a
+			   chain of substrings occurring once in each, and
+			   aligns only the gaps between these by
+			   SYNC_AUTOMATIC, unless these cover less than a
+			   quarter of the shorter stream, which is then
+			   aligned by SYNC_AUTOMATIC as a whole.  SYNC_LINES, likewise not always
+			   optimal, is quicker for streams of lines that are
+			   mostly unchanged: it matches identical lines found
+			   by a line-level patience diff, and aligns only the
+			   blocks of changed lines between them */
+
+extern long fastukk_max_edits;
+			/* if not negative, "fastukk_sync" gives up as soon as
+			   the streams are known to need more than this many
+			   edits, which may be before looking at them in full;
+			   Ukkonen's algorithm is used, whatever
+			   "fastukk_method" is unless SYNC_ANCHORED or
+			   SYNC_LINES, for which it is ignored, and it
+			   examines only the diagonals within this many of the
+			   main one; -1 (the default) sets no limit */
+
+extern long fastukk_max_cost;
+			/* if not negative, and "fastukk_max_edits" is, the
+			   streams are aligned approximately, in the manner of
+			   the heuristic of GNU diff for large files:
+			   Ukkonen's algorithm is run in rounds of this many
+			   edits (and at least one), each of which that does
+			   not reach the end of the streams commits to the
+			   alignment of its furthest point that ends in a run
+			   of at least 20 matches; a round with none is run
+			   again with up to 16 times the cost before settling
+			   for its furthest point, so that the time taken is at
+			   most proportional to the length of the streams
+			   times this cost; it is ignored with
+			   SYNC_ANCHORED or SYNC_LINES; -1 (the default) aligns
+			   optimally */
+
+extern long fastukk_excess;
+			/* after "fastukk_sync" with "fastukk_max_cost", a
+			   bound on the number of edits by which the alignment
+			   may exceed an optimal one; 0 if it is optimal */
+
+extern long fastukk_anchor_coverage;
+			/* after "fastukk_sync" with SYNC_ANCHORED, the number
+			   of characters of each stream matched by the common
+			   prefix and suffix and by anchors; with SYNC_LINES,
+			   the number matched by identical lines */
+
+#define SYNC_MAX_THREADS  64
+
+extern short fastukk_threads;
+			/* number of threads, from 1 (the default) to
+			   SYNC_MAX_THREADS, among which Ukkonen's algorithm
+			   divides each path once it has enough diagonals;
+			   the diagonals of a path depend only on those of the
+			   previous one, and the alignment found is the same
+			   for any number of threads; with SYNC_ANCHORED or
+			   SYNC_LINES, the gaps between anchors or blocks of
+			   changed lines are divided among them instead */
+
+typedef struct syncstate Syncstate;
+
+typedef
+struct
+{
+    short method;	/* as "fastukk_method" */
+    short threads;	/* as "fastukk_threads" */
+    long max_edits;	/* as "fastukk_max_edits" */
+    long max_cost;	/* as "fastukk_max_cost" */
+    long anchor_coverage;
+			/* as "fastukk_anchor_coverage" */
+    long excess;	/* as "fastukk_excess" */
+    Syncstate *state;	/* working state and scratch buffers, which are kept
+			   from one alignment to the next */
+} Synccontext;		/* options and state of "context_sync"; each thread
+			   may align texts with a context of its own, while
+			   "fastukk_sync" uses a single context of the
+			   library's and may be called by one thread only */
+
+void initialize_synccontext(/* Synccontext *context */);
+			/* sets the options of "context" to their defaults,
+			   which are those of "fastukk_sync", and gives it
+			   empty state, taken from the heap */
+
+void free_synccontext(/* Synccontext *context */);
+			/* releases the state of "context", and stops the
+			   threads that its alignments have started */
+
+Boolean context_sync(/* Synccontext *context, Synclist *synclist,
+			Text *text */);
+			/* does what "fastukk_sync" does, but with the options
+			   and state of "context" */
+
+Boolean context_array(/* Synccontext *context, Syncarray *array,
+			 Text *text */);
+			/* does what "context_sync" does, storing the results
+			   in "array" */
 
 #endif
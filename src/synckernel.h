@@ -0,0 +1,80 @@
+/**********************************************************************
+ *
+ *  synckernel.h
+ *
+ *  This file is a template for the character comparison loops of
+ *  sync.c.  It is included by sync.c once for each character width,
+ *  with these macros defined:
+ *
+ *      KERNEL_NAME(name)  name of a function specialized for the width
+ *      KERNEL_TYPE        type of a character value of the width
+ *      KERNEL_FIELD       member of Textvalue holding the characters
+ *
+ *  Both texts being compared must have the same width.  Runs of equal
+ *  characters are followed with "match_length", which compares many
+ *  characters at once.  The macros are undefined again at the end of this
+ *  file.
+ *
+ * Copyright 2026 ocreval contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You
+ * may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ **********************************************************************/
+
+static long KERNEL_NAME(longest_match)(maxlen, text1, start1, stop1, text2,
+start2, stop2, mstart1, mstart2)
+long maxlen, start1, stop1, start2, stop2, *mstart1, *mstart2;
+Text *text1, *text2;
+{
+    KERNEL_TYPE *c1 = text1->value.KERNEL_FIELD;
+    KERNEL_TYPE *c2 = text2->value.KERNEL_FIELD;
+    long s1limit, s2limit, s1, s2, increase;
+    s1limit = stop1 - maxlen;
+    s2limit = stop2 - maxlen;
+    for (s1 = start1; s1 <= s1limit; s1++)
+	for (s2 = start2; s2 <= s2limit; s2++)
+	    if (c1[s1] == c2[s2] && c1[s1] != REJECT_CHARACTER)
+	    {
+		increase = 1 + match_length((short) sizeof(KERNEL_TYPE),
+		&c1[s1 + 1], &c2[s2 + 1], min(stop1 - s1, stop2 - s2),
+		REJECT_CHARACTER) - maxlen;
+		if (increase > 0)
+		{
+		    s1limit -= increase;
+		    s2limit -= increase;
+		    maxlen  += increase;
+		    *mstart1 = s1;
+		    *mstart2 = s2;
+		}
+	    }
+    return(maxlen);
+}
+/**********************************************************************/
+
+static long KERNEL_NAME(snake)(state, i, j)
+Syncstate *state;
+long i, j;
+{
+    KERNEL_TYPE *c1 = state->a.KERNEL_FIELD, *c2 = state->b.KERNEL_FIELD;
+    long m = state->m, n = state->n;
+    /* Most snakes are short, so the first character is compared here. */
+    if (i >= m || j >= n || c1[i] != c2[j] || c1[i] == REJECT_CHARACTER)
+	return(i);
+    return(i + 1 + match_length((short) sizeof(KERNEL_TYPE), &c1[i + 1],
+    &c2[j + 1], min(m - i, n - j) - 1, REJECT_CHARACTER));
+}
+/**********************************************************************/
+
+#undef KERNEL_NAME
+#undef KERNEL_TYPE
+#undef KERNEL_FIELD
@@ -22,20 +22,34 @@
  *
  **********************************************************************/
 
+#include "output.h"
 #include "sync.h"
 
-#define usage  "[-H] [-i] [-s] [-T] textfile1 textfile2 ... >resultfile"
+#define usage  "[-a | -b | -l | -u] [-c] [-H] [-i] [-k maxedits] [-s] [-T] [-t threads] [-x maxcost] textfile1 textfile2 ... >resultfile"
 
 Textopt textopt = { True, True, 0, True, True };
 
-Boolean heuristic, show_suspect, transpose;
+Boolean anchored, bit_parallel, center, diagonal, lines, heuristic, show_suspect,
+    transpose;
+
+char *maxeditstring, *maxcoststring, *threadstring;
+
+Output output;
 
 Option option[] =
 {
+    'a', NULL, &anchored,
+    'b', NULL, &bit_parallel,
+    'l', NULL, &lines,
+    'u', NULL, &diagonal,
+    'c', NULL, &center,
     'H', NULL, &heuristic,
     'i', NULL, &textopt.case_insensitive,
+    'k', &maxeditstring, NULL,
     's', NULL, &show_suspect,
     'T', NULL, &transpose,
+    't', &threadstring, NULL,
+    'x', &maxcoststring, NULL,
     '\0'
 };
 
@@ -45,8 +59,8 @@ void write_separator()
 {
     short i;
     for (i = 1; i < 80; i++)
-	putchar('=');
-    putchar(NEWLINE);
+	OUTPUT_BYTE(&output, '=');
+    OUTPUT_BYTE(&output, NEWLINE);
 }
 /**********************************************************************/
 
@@ -56,94 +70,142 @@ Text *text;
 {
     Sync *sync;
     long i;
-    char string[STRING_SIZE];
     write_separator();
-    putchar(NEWLINE);
+    OUTPUT_BYTE(&output, NEWLINE);
     for (sync = synclist->first; sync; sync = sync->next)
     {
 	if (sync->match)
-	    printf("{%ld:", *sync->match);
-	for (i = sync->substr->start; i <= sync->substr->stop; i++)
 	{
-	    char_to_string(show_suspect & text->array[i]->suspect,
-	    text->array[i]->value, string, False);
-	    printf("%s", string);
+	    OUTPUT_BYTE(&output, '{');
+	    output_long(&output, *sync->match, 0);
+	    OUTPUT_BYTE(&output, ':');
 	}
+	for (i = sync->substr->start; i <= sync->substr->stop; i++)
+	    output_char(&output, show_suspect & TEXT_SUSPECT(text, i),
+	    TEXT_VALUE(text, i), False);
 	if (sync->match)
-	    putchar('}');
+	    OUTPUT_BYTE(&output, '}');
     }
-    putchar(NEWLINE);
+    OUTPUT_BYTE(&output, NEWLINE);
 }
 /**********************************************************************/
 
-void write_matches(synclist, num_text, text)
-Synclist *synclist;
+void write_footnote(footnote)
+long footnote;
+{
+    OUTPUT_BYTE(&output, '{');
+    output_long(&output, footnote, 0);
+    OUTPUT_BYTE(&output, '}');
+}
+/**********************************************************************/
+
+void write_matches(array, num_text, text)
+Syncarray *array;
 short num_text;
 Text *text;
 {
+    Syncview view;
     Sync *sync;
     long i, j, footnote = 0;
     Boolean suspect;
-    char string[STRING_SIZE];
     write_separator();
-    putchar(NEWLINE);
-    for (sync = synclist->first; sync; sync = sync->next)
+    OUTPUT_BYTE(&output, NEWLINE);
+    for (sync = first_sync(&view, array); sync; sync = next_sync(&view))
 	if (sync->match)
 	    for (i = 0; i < sync->substr[0].length; i++)
 	    {
 		suspect = False;
 		if (show_suspect)
 		    for (j = 0; j < num_text && !suspect; j++)
-			if (text[j].array[sync->substr[j].start + i]->suspect)
+			if (TEXT_SUSPECT(&text[j], sync->substr[j].start + i))
 			    suspect = True;
-		char_to_string(suspect,
-		text[0].array[sync->substr[0].start + i]->value, string, False);
-		printf("%s", string);
+		output_char(&output, suspect,
+		TEXT_VALUE(&text[0], sync->substr[0].start + i), False);
 	    }
 	else
-	    printf("{%ld}", ++footnote);
-    putchar(NEWLINE);
+	    write_footnote(++footnote);
+    OUTPUT_BYTE(&output, NEWLINE);
 }
 /**********************************************************************/
 
-void write_differences(synclist, num_text, text, filename)
-Synclist *synclist;
+void write_differences(array, num_text, text, filename)
+Syncarray *array;
 short num_text;
 Text *text;
 char *filename[];
 {
     long i, j, maxlen = 0, footnote = 0;
-    char format[20], string[STRING_SIZE];
+    Syncview view;
     Sync *sync;
     for (i = 0; i < num_text; i++)
 	maxlen = max(maxlen, strlen(filename[i]));
-    sprintf(format, "%%-%lds", maxlen);
-    for (sync = synclist->first; sync; sync = sync->next)
+    for (sync = first_sync(&view, array); sync; sync = next_sync(&view))
 	if (!sync->match)
 	{
 	    write_separator();
-	    printf("{%ld}\n", ++footnote);
+	    write_footnote(++footnote);
+	    OUTPUT_BYTE(&output, NEWLINE);
 	    for (i = 0; i < num_text; i++)
 	    {
-		printf(format, filename[i]);
-		printf(" {");
+		output_padded(&output, filename[i], maxlen);
+		output_string(&output, " {");
 		for (j = sync->substr[i].start; j <= sync->substr[i].stop; j++)
 		{
-		    char_to_string(show_suspect & text[i].array[j]->suspect,
-		    text[i].array[j]->value, string, False);
-		    printf("%s", string);
-		    if (text[i].array[j]->value == NEWLINE)
+		    output_char(&output, show_suspect & TEXT_SUSPECT(&text[i], j),
+		    TEXT_VALUE(&text[i], j), False);
+		    if (TEXT_VALUE(&text[i], j) == NEWLINE)
 		    {
-			printf(format, "");
-			printf("  ");
+			output_padded(&output, "", maxlen);
+			output_string(&output, "  ");
 		    }
 		}
-		printf("}\n");
+		output_string(&output, "}\n");
 	    }
 	}
 }
 /**********************************************************************/
 
+void write_exceeded(max_edits)
+long max_edits;
+{
+    write_separator();
+    output_string(&output, "\nThreshold exceeded: more than ");
+    output_long(&output, max_edits, 0);
+    output_string(&output, " edits are needed\n");
+}
+/**********************************************************************/
+
+void report_coverage(text)
+Text *text;
+{
+    fprintf(stderr, "%s: %s cover %ld of %ld characters (%.1f%%)\n",
+    exec_name, (lines ? "identical lines" : "anchors"), fastukk_anchor_coverage,
+    text[0].count, (text[0].count > 0 ? 100.0 * fastukk_anchor_coverage /
+    text[0].count : 100.0));
+}
+/**********************************************************************/
+
+long get_maxedits()
+{
+    long maxedits;
+    char extra;
+    if (!maxeditstring)
+	return(-1);
+    if (sscanf(maxeditstring, "%ld%c", &maxedits, &extra) == 1 &&
+    maxedits >= 0)
+	return(maxedits);
+    error_string("invalid maximum number of edits", maxeditstring);
+}
+/**********************************************************************/
+
+void report_excess()
+{
+    fprintf(stderr,
+    "%s: approximate alignment: at most %ld edits more than optimal\n",
+    exec_name, fastukk_excess);
+}
+/**********************************************************************/
+
 main(argc, argv)
 int argc;
 char *argv[];
@@ -151,27 +213,70 @@ char *argv[];
     Text *text;
     int i;
     Synclist synclist1, synclist2;
+    Syncarray array;
     initialize(&argc, argv, usage, option);
     if (argc < 2 || (transpose && argc > 2))
 	error("invalid number of text files");
+    if (anchored + bit_parallel + lines + diagonal > 1)
+	error("only one of -a, -b, -l and -u may be specified");
+    if (anchored)
+	fastukk_method = SYNC_ANCHORED;
+    if (lines)
+	fastukk_method = SYNC_LINES;
+    if (bit_parallel)
+	fastukk_method = SYNC_BIT_PARALLEL;
+    if (diagonal)
+	fastukk_method = SYNC_DIAGONAL;
+    fastukk_max_edits = get_maxedits();
+    if (fastukk_max_edits >= 0 && (anchored || bit_parallel || lines ||
+    heuristic || transpose || argc > 2))
+	error("-k may not be specified with -a, -b, -H, -l, -T or more than two "
+	"files");
+    fastukk_max_cost = option_value(maxcoststring, -1L, 1L, LONG_MAX,
+    "invalid maximum cost");
+    if (fastukk_max_cost >= 0 && (anchored || bit_parallel || lines ||
+    fastukk_max_edits >= 0 || heuristic || transpose || argc > 2))
+	error("-x may not be specified with -a, -b, -H, -k, -l, -T or more than "
+	"two files");
+    if (center && (heuristic || transpose || fastukk_max_edits >= 0 ||
+    fastukk_max_cost >= 0))
+	error("-c may not be specified with -H, -k, -T or -x");
+    fastukk_threads = synchronize_threads = (short) option_value(threadstring,
+    1L, 1L, (long) SYNC_MAX_THREADS, "invalid number of threads");
     text = NEW_ARRAY(argc, Text);
     for (i = 0; i < argc; i++)
 	read_text(&text[i], argv[i], &textopt);
+    open_output(&output, NULL);
     if (transpose)
     {
 	transpose_sync(&synclist1, &synclist2, &text[0], &text[1]);
 	write_transposed(&synclist1, &text[0]);
 	write_transposed(&synclist2, &text[1]);
     }
-    else
+    else if (center)
     {
-	if (heuristic || argc > 2)
-	    synchronize(&synclist1, argc, text);
-	else
-	    fastukk_sync(&synclist1, text);
-	write_matches(&synclist1, argc, text);
-	write_differences(&synclist1, argc, text, argv);
+	center_sync(&array, argc, text, -1);
+	write_matches(&array, argc, text);
+	write_differences(&array, argc, text, argv);
     }
+    else if (heuristic || argc > 2)
+    {
+	synchronize_array(&array, argc, text);
+	write_matches(&array, argc, text);
+	write_differences(&array, argc, text, argv);
+    }
+    else if (fastukk_array(&array, text))
+    {
+	if (anchored || lines)
+	    report_coverage(text);
+	if (fastukk_max_cost >= 0)
+	    report_excess();
+	write_matches(&array, argc, text);
+	write_differences(&array, argc, text, argv);
+    }
+    else
+	write_exceeded(fastukk_max_edits);
     write_separator();
+    close_output(&output);
     terminate();
 }
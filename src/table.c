@@ -72,7 +72,7 @@ Table *table;
 {
     if (table->array)
     {
-	free(table->array);
+	DISPOSE_ARRAY(table->array);
 	table->array = NULL;
     }
 }
@@ -25,9 +25,18 @@
  *
  **********************************************************************/
 
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <utf8proc.h>
 
 #include "text.h"
+#include "output.h"
+#include "unicode.h"
+#include "utf8.h"
 #include "ocreval_version.h"
 
 #define TITLE    "ocreval Vendor-Independent Interface Version " OCREVAL_VERSION "\n"
@@ -36,100 +45,209 @@
  * character: e.g., ◌̉ */
 #define DOTTED_CIRCLE 0x25CC
 
+/* Size of the blocks in which input is read and decoded. */
+#define BUFFER_SIZE  65536
+
+/* The first two bytes of a gzip-compressed file. */
+#define GZIP_MAGIC_1  0x1F
+#define GZIP_MAGIC_2  0x8B
+
+/* When this environment variable is set, the number of files read by each
+ * path is written to stderr upon exit. */
+#define READ_STATS_VARIABLE  "OCREVAL_READ_STATS"
+
+/* Texts grow by doubling, starting from this many characters. */
+#define INITIAL_TEXT_SIZE  4096
+/* Bytes needed by the suspect bitmap of a text of "size" characters. */
+#define SUSPECT_BYTES(size)  (((size) + 7) >> 3)
+
 /*
  * Assert that the internal character size is the same size as UTF-32.
  * (C89 static assert.)
  */
 static char assert_sizes[sizeof(Charvalue) == sizeof(utf8proc_int32_t) ? 1 : -1];
 
+Readstats readstats;
+
 /**********************************************************************/
 
-void append_char(text, suspect, value)
+void text_initialize(text)
 	Text *text;
-	Boolean suspect;
-	Charvalue value;
 {
-	Char *c;
-	c = NEW(Char);
-	c->suspect = suspect;
-	c->value = value;
-	list_insert_last(text, c);
+	text->value.any = NULL;
+	text->width = 1;
+	text->suspect = NULL;
+	text->count = text->size = 0;
 }
 /**********************************************************************/
 
-static Boolean read_header(f)
-	FILE *f;
+void text_empty(text)
+	Text *text;
 {
-	char line[100];
-	short divider_count = 0;
-	if (fgets(line, sizeof(line) - 1, f) &&
-			strncmp(line, TITLE, sizeof(TITLE) - 5) == 0)
+	DISPOSE_ARRAY(text->value.any);
+	DISPOSE_ARRAY(text->suspect);
+	text_initialize(text);
+}
+/**********************************************************************/
+
+void reserve_text(text, size)
+	Text *text;
+	long size;
+{
+	void *value;
+	unsigned char *suspect;
+	if (size <= text->size)
+		return;
+	/* A statically initialized text starts out narrow. */
+	if (text->width == 0)
+		text->width = 1;
+	size = max(size, max(2 * text->size, INITIAL_TEXT_SIZE));
+	value = allocate((size_t) size, (size_t) text->width);
+	suspect = NEW_ARRAY(SUSPECT_BYTES(size), unsigned char);
+	if (text->count > 0)
 	{
-		while (divider_count < 2 && fgets(line, sizeof(line) - 1, f))
-			if (strcmp(line, DIVIDER) == 0)
-				divider_count++;
-		return(True);
+		memcpy(value, text->value.any, text->count * text->width);
+		memcpy(suspect, text->suspect, SUSPECT_BYTES(text->count));
 	}
-	rewind(f);
-	return(False);
+	DISPOSE_ARRAY(text->value.any);
+	DISPOSE_ARRAY(text->suspect);
+	text->value.any = value;
+	text->suspect = suspect;
+	text->size = size;
 }
 /**********************************************************************/
 
-static void read_contents(f, text, find_markers, suspect_marker)
-	FILE *f;
+void widen_text(text, width)
 	Text *text;
-	Boolean find_markers;
-	int suspect_marker;
+	short width;
 {
-	Boolean suspect = False;
+	Textvalue value;
+	long i;
+	if (width <= text->width)
+		return;
+	if (text->size == 0)
+	{
+		text->width = width;
+		return;
+	}
+	value.any = allocate((size_t) text->size, (size_t) width);
+	if (width == 2)
+		for (i = 0; i < text->count; i++)
+			value.bmp[i] = text->value.latin1[i];
+	else
+		for (i = 0; i < text->count; i++)
+			value.ucs4[i] = TEXT_VALUE(text, i);
+	DISPOSE_ARRAY(text->value.any);
+	text->value = value;
+	text->width = width;
+}
+/**********************************************************************/
 
-	/* Buffer for one full UTF-8 code unit. */
-	utf8proc_uint8_t buffer[4];
+void set_value(text, i, value)
+	Text *text;
+	long i;
+	Charvalue value;
+{
+	if (CHARVALUE_WIDTH(value) > text->width)
+		widen_text(text, (short) CHARVALUE_WIDTH(value));
+	switch (text->width)
+	{
+		case 1:
+			text->value.latin1[i] = (uint8_t) value;
+			break;
+		case 2:
+			text->value.bmp[i] = (uint16_t) value;
+			break;
+		default:
+			text->value.ucs4[i] = value;
+	}
+}
+/**********************************************************************/
 
-	int byte, read_status, decode_status;
-	size_t code_unit_size;
-	utf8proc_int32_t code_point;
-	byte = getc(f);
+void set_suspect(text, i, suspect)
+	Text *text;
+	long i;
+	Boolean suspect;
+{
+	if (suspect)
+		text->suspect[i >> 3] |= (1 << (i & 7));
+	else
+		text->suspect[i >> 3] &= ~(1 << (i & 7));
+}
+/**********************************************************************/
 
-	while (byte != EOF)
-	{
-		code_unit_size = utf8proc_utf8class[byte];
-		if (code_unit_size < 1) {
-			/* Encoding error! Stream is not UTF-8! */
-			error("invalid UTF-8 character");
-		}
+void append_char(text, suspect, value)
+	Text *text;
+	Boolean suspect;
+	Charvalue value;
+{
+	if (text->count == text->size)
+		reserve_text(text, text->count + 1);
+	set_value(text, text->count, value);
+	set_suspect(text, text->count, suspect);
+	text->count++;
+}
+/**********************************************************************/
 
-		buffer[0] = byte;
-		/* Read the remaining bytes into the buffer. */
-		if (code_unit_size > 1) {
-			read_status = fread(
-					buffer + 1,
-					sizeof(utf8proc_uint8_t),
-					/* The first byte is already in the buffer. */
-					code_unit_size - 1,
-					f
-					);
-
-			if (read_status != (code_unit_size - 1)) {
-				/* Could not read enough bytes. */
-				error("unexpected end of input");
-			}
-		}
+typedef
+struct
+{
+	Boolean looking;	/* True until the header, if any, has been skipped */
+	Boolean found;		/* True if the first line is the title */
+	Boolean in_line;	/* True if the bytes that follow continue a line
+				   that has been partly skipped */
+	short divider_count;	/* dividers skipped so far */
+} Header;
+/**********************************************************************/
 
-		/* Decode a single code unit -> code point. */
-		decode_status = utf8proc_iterate(buffer, sizeof(buffer), &code_point);
-		if (decode_status != code_unit_size) {
-			error(utf8proc_errmsg(decode_status));
+static long skip_header(header, bytes, length, final)
+	Header *header;
+	unsigned char *bytes;
+	long length;
+	Boolean final;
+{
+	long i = 0, title_length = sizeof(TITLE) - 5;
+	unsigned char *newline;
+	if (!header->found)
+	{
+		/* Wait for enough of the first line to recognize the title. */
+		if (length < title_length && !final &&
+				!memchr(bytes, NEWLINE, (size_t) length))
+			return(0);
+		if (length < title_length || memcmp(bytes, TITLE,
+				(size_t) title_length) != 0)
+		{
+			header->looking = False;
+			return(0);
 		}
-
-		if (find_markers && code_point == suspect_marker) {
-			suspect = True;
-		} else {
-			append_char(text, suspect, code_point);
-			suspect = False;
+		header->found = True;
+		header->in_line = True;
+	}
+	while (header->divider_count < 2)
+	{
+		newline = memchr(&bytes[i], NEWLINE, (size_t) (length - i));
+		if (!newline)
+		{
+			/* Keep a partial line until the rest of it is read, unless
+			 * it fills the block, in which case it is too long to be a
+			 * divider. */
+			if (final || i == 0)
+			{
+				header->in_line = True;
+				i = length;
+			}
+			if (final)
+				header->looking = False;
+			return(i);
 		}
-		byte = getc(f);
+		if (!header->in_line && newline - &bytes[i] == sizeof(DIVIDER) - 2 &&
+				memcmp(&bytes[i], DIVIDER, sizeof(DIVIDER) - 1) == 0)
+			header->divider_count++;
+		header->in_line = False;
+		i = newline - bytes + 1;
 	}
+	header->looking = False;
+	return(i);
 }
 /**********************************************************************/
 
@@ -137,10 +255,8 @@ static void read_contents(f, text, find_markers, suspect_marker)
  * Blank characters EXCEPT the newline!
  */
 static Boolean is_blank(character)
-	utf8proc_int32_t character;
+	Charvalue character;
 {
-	const utf8proc_property_t * props = utf8proc_get_property(character);
-
 	/* Cases from ISRI < 6.0 */
 	switch (character) {
 		case NEWLINE:
@@ -156,7 +272,7 @@ static Boolean is_blank(character)
 	}
 
 	/* See: http://www.unicode.org/versions/Unicode8.0.0/ch04.pdf */
-	switch (props->category) {
+	switch (UNICODE_CATEGORY(character)) {
 		case UTF8PROC_CATEGORY_ZS:  /* Space characters. */
 		case UTF8PROC_CATEGORY_ZL:  /* Line separators. */
 		case UTF8PROC_CATEGORY_ZP:  /* Paragraph separators. */
@@ -165,52 +281,254 @@ static Boolean is_blank(character)
 
 	return False;
 }
+/**********************************************************************/
+
+/* Blank characters among the ASCII characters, except the newline. */
+#define IS_ASCII_BLANK(c)  ((c) == ' ' || (c) == '\t' || \
+		((c) >= LINE_TABULATION && (c) <= CARRIAGE_RETURN))
+#define ASCII_LOWERCASE(c)  ((c) >= 'A' && (c) <= 'Z' ? (c) + ('a' - 'A') : (c))
 
+typedef
+struct
+{
+	short options;		/* the filter options, as an index into
+				   "filter_table" */
+	Boolean found_non_blank;
+				/* True if a character other than a blank has been
+				   kept since the last newline */
+	long blank;		/* index of a blank that is to be removed if it
+				   ends the line, or -1 */
+} Filter;
+
+#define FILTER_FIELD  latin1
+
+#define FILTER_NAME       normalize_filter_1
+#define FILTER_NORMALIZE  1
+#define FILTER_FOLD       0
+#include "textfilter.h"
+
+#define FILTER_NAME       fold_filter_1
+#define FILTER_NORMALIZE  0
+#define FILTER_FOLD       1
+#include "textfilter.h"
+
+#define FILTER_NAME       normalize_fold_filter_1
+#define FILTER_NORMALIZE  1
+#define FILTER_FOLD       1
+#include "textfilter.h"
+
+#undef FILTER_FIELD
+
+#define FILTER_FIELD  bmp
+
+#define FILTER_NAME       normalize_filter_2
+#define FILTER_NORMALIZE  1
+#define FILTER_FOLD       0
+#include "textfilter.h"
+
+#define FILTER_NAME       fold_filter_2
+#define FILTER_NORMALIZE  0
+#define FILTER_FOLD       1
+#include "textfilter.h"
+
+#define FILTER_NAME       normalize_fold_filter_2
+#define FILTER_NORMALIZE  1
+#define FILTER_FOLD       1
+#include "textfilter.h"
+
+#undef FILTER_FIELD
+
+#define FILTER_FIELD  ucs4
+
+#define FILTER_NAME       normalize_filter_4
+#define FILTER_NORMALIZE  1
+#define FILTER_FOLD       0
+#include "textfilter.h"
+
+#define FILTER_NAME       fold_filter_4
+#define FILTER_NORMALIZE  0
+#define FILTER_FOLD       1
+#include "textfilter.h"
+
+#define FILTER_NAME       normalize_fold_filter_4
+#define FILTER_NORMALIZE  1
+#define FILTER_FOLD       1
+#include "textfilter.h"
+
+#undef FILTER_FIELD
+
+/* Filters indexed by width and options (normalize, fold, or both). */
+#define NORMALIZE_OPTION  1
+#define FOLD_OPTION       2
+#define WIDTH_INDEX(width)  ((width) >> 1)
+static void (*filter_table[3][4])() =
+{
+	{ NULL, normalize_filter_1, fold_filter_1, normalize_fold_filter_1 },
+	{ NULL, normalize_filter_2, fold_filter_2, normalize_fold_filter_2 },
+	{ NULL, normalize_filter_4, fold_filter_4, normalize_fold_filter_4 }
+};
+/**********************************************************************/
 
+static void filter_initialize(filter, textopt)
+	Filter *filter;
+	Textopt *textopt;
+{
+	filter->options = (textopt->normalize ? NORMALIZE_OPTION : 0) |
+			(textopt->case_insensitive ? FOLD_OPTION : 0);
+	filter->found_non_blank = False;
+	filter->blank = -1;
+}
 /**********************************************************************/
 
-static void compress_spacing(text, start)
+static void filter_finish(filter, text)
+	Filter *filter;
 	Text *text;
-	Char *start;
 {
-	Boolean found_non_blank = False;
-	Char *c, *next;
+	/* A blank that ends the text is removed. */
+	if (filter->blank >= 0)
+	{
+		set_suspect(text, filter->blank, False);
+		text->count = filter->blank;
+	}
+}
+/**********************************************************************/
 
-	/* Normalize all blank-y charcaters to BLANK. */
-	for (c = start; c; c = c->next)
-		if (is_blank(c->value))
-			c->value = BLANK;
+static long decode_block(decoder, filter, bytes, length, final)
+	Decoder *decoder;
+	Filter *filter;
+	unsigned char *bytes;
+	long length;
+	Boolean final;
+{
+	Text *text = decoder->text;
+	long start = text->count;
+	void (*apply)();
+	length = decode_utf8(decoder, bytes, length, final);
+	/* Filter the characters while they are still in the cache; the text
+	 * may have been widened by this block. */
+	apply = filter_table[WIDTH_INDEX(text->width)][filter->options];
+	if (apply)
+		(*apply)(filter, text, start);
+	return(length);
+}
+/**********************************************************************/
 
-	c = start;
-	while (c)
+static void read_contents(f, filename, header, decoder, filter)
+	gzFile f;
+	char *filename;
+	Header *header;
+	Decoder *decoder;
+	Filter *filter;
+{
+	unsigned char buffer[BUFFER_SIZE];
+	size_t length = 0, decoded;
+	int read_count, status;
+	const char *reason;
+	char message[256];
+	while ((read_count = gzread(f, &buffer[length],
+					(unsigned) (BUFFER_SIZE - length))) > 0)
 	{
-		next = c->next;
-		if ((c->value == BLANK && (!found_non_blank || !next ||
-						next->value == BLANK || next->value == NEWLINE)) ||
-				(c->value == NEWLINE && !found_non_blank))
+		length += read_count;
+		if (header->looking)
 		{
-			if (found_non_blank && next && next->value == BLANK)
-				next->suspect |= c->suspect;
-			list_remove(text, c);
-			free(c);
-		} else {
-			found_non_blank = (c->value == NEWLINE ? False : True);
+			/* The header is skipped in the buffer rather than by seeking,
+			 * so that a pipe may be read. */
+			decoded = skip_header(header, buffer, (long) length, False);
+			decoder->offset += decoded;
+			if (header->looking)
+			{
+				memmove(buffer, &buffer[decoded], length - decoded);
+				length -= decoded;
+				continue;
+			}
 		}
-
-		c = next;
+		else
+			decoded = 0;
+		decoded += decode_block(decoder, filter, &buffer[decoded],
+				(long) (length - decoded), False);
+		/* Keep an incomplete sequence for the next block. */
+		memmove(buffer, &buffer[decoded], length - decoded);
+		length -= decoded;
 	}
+	/* This also catches a truncated compressed file. */
+	reason = gzerror(f, &status);
+	if (read_count < 0 || status != Z_OK)
+	{
+		/* zlib names the stream by its descriptor, as "<fd:N>: ". */
+		if (strncmp(reason, "<fd:", 4) == 0 && strstr(reason, ": "))
+			reason = strstr(reason, ": ") + 2;
+		sprintf(message, "unable to read (%.200s)", reason);
+		error_string(message, (filename ? filename : "stdin"));
+	}
+	decoded = 0;
+	if (header->looking)
+	{
+		decoded = skip_header(header, buffer, (long) length, True);
+		decoder->offset += decoded;
+	}
+	decode_block(decoder, filter, &buffer[decoded], (long) (length - decoded),
+			True);
 }
 /**********************************************************************/
 
-static void lowercase(start)
-	Char *start;
+static Boolean map_contents(f, header, decoder, filter)
+	FILE *f;
+	Header *header;
+	Decoder *decoder;
+	Filter *filter;
 {
-	Char *c;
-	for (c = start; c; c = c->next)
-		/* Delegate to utf8proc. */
-		c->value = utf8proc_tolower(c->value);
+	struct stat status;
+	unsigned char *contents;
+	long offset, length;
+	size_t size;
+
+	/* Only regular files can be mapped; everything else is streamed. */
+	if (fstat(fileno(f), &status) != 0 || !S_ISREG(status.st_mode) ||
+			status.st_size <= 0 || (off_t) (size_t) status.st_size !=
+			status.st_size)
+		return(False);
+	offset = ftell(f);
+	size = (size_t) status.st_size;
+	if (offset < 0 || (size_t) offset > size)
+		return(False);
+	contents = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+	if (contents == MAP_FAILED)
+		return(False);
+	/* A compressed file is decompressed as it is read instead. */
+	if (size - offset >= 2 && contents[offset] == GZIP_MAGIC_1 &&
+			contents[offset + 1] == GZIP_MAGIC_2)
+	{
+		munmap(contents, size);
+		return(False);
+	}
+	posix_madvise(contents, size, POSIX_MADV_SEQUENTIAL);
+	if (header->looking)
+	{
+		length = skip_header(header, &contents[offset], (long) (size - offset),
+				True);
+		decoder->offset += length;
+		offset += length;
+	}
+
+	/* Decode a block at a time so each block is still in the cache when
+	 * it is decoded after being validated. */
+	while ((size_t) offset < size)
+	{
+		length = (long) min(size - offset, BUFFER_SIZE);
+		offset += decode_block(decoder, filter, &contents[offset], length,
+				(size_t) offset + length == size);
+	}
+	munmap(contents, size);
+	return(True);
 }
+/**********************************************************************/
 
+static void report_readstats()
+{
+	fprintf(stderr, "%s: %ld file(s) memory-mapped, %ld file(s) streamed "
+			"(%ld decompressed)\n", exec_name, readstats.mapped,
+			readstats.streamed, readstats.decompressed);
+}
 /**********************************************************************/
 
 void read_text(text, filename, textopt)
@@ -218,21 +536,53 @@ void read_text(text, filename, textopt)
 	char *filename;
 	Textopt *textopt;
 {
-	Char *last;
+	static Boolean first_call = True;
+	Decoder decoder;
+	Header header;
+	Filter filter;
+	long offset;
 	FILE *f;
-	if (textopt->find_header && !filename)
-		error_string("invalid call to", "read_text");
-	last = text->last;
+	gzFile gz;
+	int fd;
+	if (first_call)
+	{
+		first_call = False;
+		if (getenv(READ_STATS_VARIABLE))
+			atexit(report_readstats);
+	}
 	f = open_file(filename, "r");
-	if (textopt->find_header)
-		textopt->found_header = read_header(f);
-	read_contents(f, text, textopt->find_markers,
+	header.looking = textopt->find_header;
+	header.found = header.in_line = False;
+	header.divider_count = 0;
+	decoder_initialize(&decoder, text, textopt->find_markers,
 			(textopt->suspect_marker ? textopt->suspect_marker : SUSPECT_MARKER));
+	filter_initialize(&filter, textopt);
+	/* Report invalid sequences relative to the start of the file. */
+	offset = ftell(f);
+	if (offset > 0)
+		decoder.offset = offset;
+	if (map_contents(f, &header, &decoder, &filter))
+		readstats.mapped++;
+	else
+	{
+		/* The stream is read through zlib, which passes uncompressed
+		 * input through unchanged. */
+		fd = dup(fileno(f));
+		gz = (fd >= 0 ? gzdopen(fd, "rb") : NULL);
+		if (!gz)
+			error_string("unable to open file", (filename ? filename :
+					"stdin"));
+		gzbuffer(gz, BUFFER_SIZE);
+		read_contents(gz, filename, &header, &decoder, &filter);
+		if (!gzdirect(gz))
+			readstats.decompressed++;
+		gzclose(gz);
+		readstats.streamed++;
+	}
 	close_file(f);
-	if (textopt->normalize)
-		compress_spacing(text, (last ? last->next : text->first));
-	if (textopt->case_insensitive)
-		lowercase(last ? last->next : text->first);
+	if (textopt->find_header)
+		textopt->found_header = header.found;
+	filter_finish(&filter, text);
 }
 
 /**********************************************************************/
@@ -253,16 +603,14 @@ signed char encode_or_die(codepoint, buffer)
  * Is this generally considered to be a graphic character?
  */
 static Boolean is_graphic_character(character)
-	utf8proc_int32_t character;
+	Charvalue character;
 {
-	const utf8proc_property_t * props = utf8proc_get_property(character);
-
 	/* Special case the space character. */
 	if (character == ' ') {
 	    return true;
 	}
 
-	switch (props->category) {
+	switch (UNICODE_CATEGORY(character)) {
 		case UTF8PROC_CATEGORY_LU: /**< Letter, uppercase */
 		case UTF8PROC_CATEGORY_LL: /**< Letter, lowercase */
 		case UTF8PROC_CATEGORY_LT: /**< Letter, titlecase */
@@ -299,9 +647,9 @@ static Boolean is_graphic_character(character)
  *
  */
 static Boolean is_combining_character(character)
-	utf8proc_int32_t character;
+	Charvalue character;
 {
-    switch (utf8proc_category(character)) {
+    switch (UNICODE_CATEGORY(character)) {
         case UTF8PROC_CATEGORY_MN:
         case UTF8PROC_CATEGORY_MC:
         case UTF8PROC_CATEGORY_ME:
@@ -312,7 +660,26 @@ static Boolean is_combining_character(character)
 }
 /**********************************************************************/
 
-void char_to_string(suspect, value, string, fake_newline)
+/* Writes "<HH>" or "<HHHH>", at least "digits" hex digits, to "string";
+ * returns its length. */
+static short hex_to_string(value, digits, string)
+	Charvalue value;
+	short digits;
+	char *string;
+{
+	static char hex[] = "0123456789ABCDEF";
+	short i, n;
+	for (n = digits; n < 8 && (value >> (4 * n)) != 0; n++);
+	string[0] = '<';
+	for (i = 0; i < n; i++)
+		string[n - i] = hex[(value >> (4 * i)) & 0xF];
+	string[n + 1] = '>';
+	string[n + 2] = '\0';
+	return(n + 2);
+}
+/**********************************************************************/
+
+short char_to_string(suspect, value, string, fake_newline)
 	Boolean suspect;
 	Charvalue value;
 	char *string;
@@ -327,7 +694,11 @@ void char_to_string(suspect, value, string, fake_newline)
 	}
 
 	if (value == NEWLINE) {
-		sprintf(&string[i], (fake_newline ? "<\\n>" : "\n"));
+		if (fake_newline) {
+			strcpy(&string[i], "<\\n>");
+			return(i + 4);
+		}
+		string[i++] = '\n';
 	} else if (is_graphic_character(value)) {
 		if (is_combining_character(value)) {
 			i += encode_or_die(DOTTED_CIRCLE, &ustring[i]);
@@ -335,12 +706,11 @@ void char_to_string(suspect, value, string, fake_newline)
 
 		/* It's a printable character. */
 		i += encode_or_die(value, &ustring[i]);
-		string[i++] = '\0';
-	} else if (value < 256) {
-		sprintf(&string[i], "<%02X>", value);
 	} else {
-		sprintf(&string[i], "<%04X>", value);
+		return(i + hex_to_string(value, (value < 256 ? 2 : 4), &string[i]));
 	}
+	string[i] = '\0';
+	return(i);
 }
 /**********************************************************************/
 
@@ -349,23 +719,20 @@ void write_text(text, filename, write_header)
 	char *filename;
 	void (*write_header)();
 {
-	FILE *f;
-	Char *c;
-	char string[STRING_SIZE];
-	f = open_file(filename, "w");
+	Output output;
+	long i;
+	open_output(&output, filename);
 	if (write_header)
 	{
-		fputs(TITLE, f);
-		fputs(DIVIDER, f);
-		(*write_header)(f);
-		fputs(DIVIDER, f);
+		output_string(&output, TITLE);
+		output_string(&output, DIVIDER);
+		(*write_header)(&output);
+		output_string(&output, DIVIDER);
 	}
-	for (c = text->first; c; c = c->next)
-	{
-		char_to_string(c->suspect, c->value, string, False);
-		fputs(string, f);
-	}
-	close_file(f);
+	for (i = 0; i < text->count; i++)
+		output_char(&output, TEXT_SUSPECT(text, i), TEXT_VALUE(text, i),
+				False);
+	close_output(&output);
 }
 
 /**********************************************************************/
@@ -4,9 +4,13 @@
  *
  *  This module provides definitions and routines to support the reading
  *  and writing of OCR-generated text.  A "Text" structure is defined to
- *  be a linked list of "Char" structures, where each "Char" structure
- *  gives the value of one 32-bit Unicode character and indicates whether it
- *  is suspect.
+ *  be a contiguous array of Unicode character values, together with a
+ *  packed bitmap that indicates which characters are suspect.  The
+ *  values are stored in 1, 2 or 4 bytes each, the narrowest width that
+ *  holds every character of the text, and the array is widened when a
+ *  wider character is stored; so they must be read with "TEXT_VALUE",
+ *  which returns a 32-bit "Charvalue" whatever the width, and written
+ *  with "set_value" or "append_char".
  *
  *  Author: Stephen V. Rice (1996)
  *  Author: Eddie Antonio Santos (2015)
@@ -34,7 +38,6 @@
 
 #include <stdint.h>
 
-#include "list.h"
 #include "util.h"
 
 #define BLANK               ' '
@@ -62,13 +65,64 @@ typedef uint32_t Charvalue;
  * WITH a suspect marker! */
 #define STRING_SIZE (max(sizeof("^◌𐇽"), sizeof("<10FFFF>")))
 
-BEGIN_ITEM(Char)
-    Boolean suspect;
-    Charvalue value;
-END_ITEM(Char);
+typedef
+union
+{
+    uint8_t *latin1;    /* character values when "width" is 1 */
+    uint16_t *bmp;      /* character values when "width" is 2 */
+    Charvalue *ucs4;    /* character values when "width" is 4 */
+    void *any;
+} Textvalue;
 
-BEGIN_LIST_OF(Char)
-END_LIST(Text);
+typedef
+struct
+{
+    Textvalue value;    /* array of "count" character values */
+    short width;        /* bytes per character value: 1 if every character
+                           is in Latin-1, 2 if every character is in the Basic
+                           Multilingual Plane, else 4 */
+    unsigned char *suspect;
+                        /* bitmap indicating which characters are suspect;
+                           bit i is set if character i is suspect */
+    long count;         /* number of characters in the text */
+    long size;          /* number of characters allocated */
+} Text;                 /* a Text may be initialized statically or by
+                           "text_initialize" */
+
+#define TEXT_VALUE(text, i)  \
+    ((text)->width == 1 ? (Charvalue) (text)->value.latin1[i] : \
+     (text)->width == 2 ? (Charvalue) (text)->value.bmp[i] : \
+     (text)->value.ucs4[i])
+                        /* the value of character i of "text" */
+#define TEXT_SUSPECT(text, i)  \
+    ((Boolean) (((text)->suspect[(i) >> 3] >> ((i) & 7)) & 1))
+                        /* True if character i of "text" is suspect */
+#define CHARVALUE_WIDTH(value)  \
+    ((value) <= 0xFF ? 1 : (value) <= 0xFFFF ? 2 : 4)
+                        /* the narrowest width that can hold "value" */
+
+void text_initialize(/* Text *text */);
+                        /* initializes "text" to be empty */
+
+void text_empty(/* Text *text */);
+                        /* de-allocates the characters of "text" and leaves it
+                           empty */
+
+void reserve_text(/* Text *text, long size */);
+                        /* ensures that "text" can hold "size" characters
+                           without being re-allocated; the suspect bits of
+                           characters beyond "count" are always clear */
+
+void widen_text(/* Text *text, short width */);
+                        /* converts the character values of "text" to the
+                           given width, if it is wider than the current one */
+
+void set_value(/* Text *text, long i, Charvalue value */);
+                        /* stores "value" as character i of "text", widening
+                           the text if necessary */
+
+void set_suspect(/* Text *text, long i, Boolean suspect */);
+                        /* marks character i of "text" as suspect or not */
 
 void append_char(/* Text *text, Boolean suspect, Charvalue value */);
                         /* appends the given character to "text" */
@@ -99,19 +153,39 @@ struct
 
 void read_text(/* Text *text, char *filename, Textopt *textopt */);
                         /* reads the named file (or stdin if "filename" is NULL
-                           and "textopt->find_header" is False) based on the
-                           options specified in "textopt", and appends each
-                           character to "text"; reports an error and quits if
-                           unable to open the file */
+                           or "-") based on the options specified in "textopt",
+                           and appends each character to "text"; the header is
+                           detected without seeking, so any file may be a pipe;
+                           a regular file is memory-mapped and decoded in place,
+                           while stdin, pipes, FIFOs and gzip-compressed files
+                           are read through a buffer; reports an error and
+                           quits if unable to open the file */
 
-void char_to_string(/* Boolean suspect, Charvalue value, char *string,
-                       Boolean fake_newline */);
+typedef
+struct
+{
+    long mapped;        /* number of files read by "read_text" through a
+                           memory mapping */
+    long streamed;      /* number of files read by "read_text" through a
+                           buffer */
+    long decompressed;  /* number of the streamed files that were
+                           gzip-compressed */
+} Readstats;
+
+extern Readstats readstats;
+                        /* counts the files read by each path; if the
+                           environment variable OCREVAL_READ_STATS is set,
+                           these counts are written to stderr upon exit */
+
+short char_to_string(/* Boolean suspect, Charvalue value, char *string,
+                        Boolean fake_newline */);
                         /* stores a representation of the given character in
                            "string", which must be at least STRING_SIZE bytes; a
                            non-printable character is represented by a hex value
                            of the form <FF> or <FFFF>; if "fake_newline" is
                            True, the newline character is represented by <\n>,
-                           which is desirable for some reports */
+                           which is desirable for some reports; returns the
+                           length of the representation */
 
 signed char encode_or_die(/* Charvalue value, char *string */);
                         /* writes a Unicode value to the given string;
@@ -119,17 +193,18 @@ signed char encode_or_die(/* Charvalue value, char *string */);
                          * returns characters written to string */
 
 Boolean cstring_to_text(Text* text, const char *string);
-                        /* appends the UTF-8 string to the text list;
+                        /* appends the UTF-8 string to the text;
                          * exits if the value cannot be written; */
 
 
 void write_text(/* Text *text, char *filename,
-                   void (*write_header)(FILE *f) */);
+                   void (*write_header)(Output *output) */);
                         /* writes each character of "text" to the named file
                            (or stdout if "filename" is NULL) using
                            "char_to_string" to represent the characters;
                            if "write_header" is non-NULL, this routine is
-                           called to write a header to the file; reports an
-                           error and quits if unable to create the file */
+                           called to write a header to the Output (see
+                           output.h); reports an error and quits if unable
+                           to create the file */
 
 #endif
@@ -0,0 +1,101 @@
+/**********************************************************************
+ *
+ *  textfilter.h
+ *
+ *  This file is a template for the filters applied by "read_text" as
+ *  each block of input is decoded.  It is included by text.c once for
+ *  each combination of options and character width, with these macros
+ *  defined:
+ *
+ *      FILTER_NAME       name of the filter function to be defined
+ *      FILTER_FIELD      member of Textvalue holding the characters
+ *      FILTER_NORMALIZE  1 to normalize and compress spacing, else 0
+ *      FILTER_FOLD       1 to convert characters to lowercase, else 0
+ *
+ *  so that the loop over the characters contains no option tests.  All
+ *  but FILTER_FIELD are undefined again at the end of this file.
+ *
+ * Copyright 2026 ocreval contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You
+ * may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ **********************************************************************/
+
+static void FILTER_NAME(filter, text, start)
+	Filter *filter;
+	Text *text;
+	long start;
+{
+	long i, j = start, count = text->count;
+	Charvalue value;
+	Boolean suspect;
+#if !FILTER_NORMALIZE
+	(void) filter;		/* only normalizing keeps state */
+#endif
+	for (i = start; i < count; i++)
+	{
+		value = text->value.FILTER_FIELD[i];
+		suspect = TEXT_SUSPECT(text, i);
+#if FILTER_NORMALIZE
+		if (value < 0x80 ? IS_ASCII_BLANK(value) : is_blank(value))
+		{
+			/* Blanks at the start of a line are removed, and a run of
+			 * blanks is compressed into one that is suspect if any of
+			 * them is; it is removed later if it ends the line. */
+			if (!filter->found_non_blank)
+				continue;
+			if (filter->blank >= 0)
+			{
+				if (suspect)
+					set_suspect(text, filter->blank, True);
+				continue;
+			}
+			filter->blank = j;
+			value = BLANK;
+		}
+		else if (value == NEWLINE)
+		{
+			if (filter->blank >= 0)
+			{
+				j = filter->blank;
+				filter->blank = -1;
+			}
+			/* Empty lines are removed. */
+			if (!filter->found_non_blank)
+				continue;
+			filter->found_non_blank = False;
+		}
+		else
+		{
+			filter->blank = -1;
+			filter->found_non_blank = True;
+		}
+#endif
+#if FILTER_FOLD
+		value = (value < 0x80 ? ASCII_LOWERCASE(value) :
+				UNICODE_LOWERCASE(value));
+#endif
+		/* Folding never takes a character out of its width. */
+		text->value.FILTER_FIELD[j] = value;
+		set_suspect(text, j++, suspect);
+	}
+#if FILTER_NORMALIZE
+	for (i = j; i < count; i++)
+		set_suspect(text, i, False);
+	text->count = j;
+#endif
+}
+
+#undef FILTER_NAME
+#undef FILTER_NORMALIZE
+#undef FILTER_FOLD
@@ -0,0 +1,74 @@
+/**********************************************************************
+ *
+ *  unicode.h
+ *
+ *  This module provides the properties of each Unicode character that
+ *  are needed by the library: its general category, its lowercase form,
+ *  its word break property and its character class.  They are kept in a
+ *  two-stage table generated at build time by
+ *  libexec/generate_unicode_property.c: the upper bits of a character
+ *  value select a page, which gives the index of a leaf holding the
+ *  properties of each character of the page.  Pages with the same
+ *  properties share a leaf.
+ *
+ * Copyright 2026 ocreval contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You
+ * may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ **********************************************************************/
+
+#ifndef _UNICODE_
+#define _UNICODE_
+
+#include "text.h"
+
+#define UNICODE_LEAF_SHIFT  6
+#define UNICODE_LEAF_SIZE   (1 << UNICODE_LEAF_SHIFT)
+#define UNICODE_NUM_PAGES   (0x110000 >> UNICODE_LEAF_SHIFT)
+
+typedef
+struct
+{
+    int32_t lowercase;          /* difference between the lowercase form of
+                                   the character and the character */
+    unsigned char category;     /* general category, as utf8proc_category_t */
+    unsigned char word_break;   /* word break property, as wb_property */
+    unsigned char charclass;    /* character class, as Charclass */
+} Uniprop;
+
+extern const unsigned short unicode_page[UNICODE_NUM_PAGES];
+                        /* index in "unicode_leaf" of each page */
+
+extern const Uniprop unicode_leaf[][UNICODE_LEAF_SIZE];
+                        /* properties of the characters of each distinct
+                           page */
+
+extern char *unicode_charclass_name[];
+                        /* name of each character class */
+
+extern const short unicode_num_charclasses;
+                        /* number of character classes */
+
+#define UNICODE_PROPERTY(value) \
+    (&unicode_leaf[unicode_page[(value) >> UNICODE_LEAF_SHIFT]] \
+    [(value) & (UNICODE_LEAF_SIZE - 1)])
+                        /* returns a pointer to the Uniprop of the given
+                           character value, which must not exceed U+10FFFF;
+                           "value" is evaluated twice */
+
+#define UNICODE_CATEGORY(value)  (UNICODE_PROPERTY(value)->category)
+
+#define UNICODE_LOWERCASE(value) \
+    ((Charvalue) ((value) + UNICODE_PROPERTY(value)->lowercase))
+
+#endif
@@ -0,0 +1,620 @@
+/**********************************************************************
+ *
+ *  utf8.c
+ *
+ * Copyright 2026 ocreval contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You
+ * may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ **********************************************************************/
+
+#include "utf8.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define X86_SIMD
+#include <immintrin.h>
+#define TARGET(isa)  __attribute__ ((target (isa)))
+#endif
+
+/* Continuation bytes have the form 10xxxxxx. */
+#define IS_CONTINUATION(byte)  (((byte) & 0xC0) == 0x80)
+
+typedef long (*Copier)(/* unsigned char *bytes, long length, void *value,
+                          int marker */);
+
+static Boolean initialized = False;
+static Boolean use_avx2 = False;
+/* Copiers for texts of width 1, 2 and 4, indexed by width / 2, or NULL
+ * when no SIMD is available to copy ASCII in bulk. */
+static Copier copy_ascii[3];
+
+/**********************************************************************/
+
+/*
+ * Returns the length of the sequence introduced by the given lead byte, or 0
+ * if the byte cannot start a sequence.
+ */
+static int sequence_length(byte)
+    unsigned char byte;
+{
+    if (byte < 0x80)
+        return 1;
+    if (byte < 0xC2)
+        return 0;       /* continuation byte or overlong 2-byte form */
+    if (byte < 0xE0)
+        return 2;
+    if (byte < 0xF0)
+        return 3;
+    if (byte < 0xF5)
+        return 4;
+    return 0;
+}
+/**********************************************************************/
+
+/*
+ * Decodes the sequence of "length" bytes at "bytes", which must already be
+ * known to be valid.
+ */
+static Charvalue decode_sequence(bytes, length)
+    unsigned char *bytes;
+    int length;
+{
+    switch (length) {
+        case 1:
+            return bytes[0];
+        case 2:
+            return ((bytes[0] & 0x1F) << 6) | (bytes[1] & 0x3F);
+        case 3:
+            return ((bytes[0] & 0x0F) << 12) | ((bytes[1] & 0x3F) << 6) |
+                (bytes[2] & 0x3F);
+        default:
+            return ((Charvalue) (bytes[0] & 0x07) << 18) |
+                ((bytes[1] & 0x3F) << 12) | ((bytes[2] & 0x3F) << 6) |
+                (bytes[3] & 0x3F);
+    }
+}
+/**********************************************************************/
+
+/*
+ * Returns True if the "length" bytes at "bytes" form a valid sequence. The
+ * lead byte must already have been checked with sequence_length().
+ */
+static Boolean valid_sequence(bytes, length)
+    unsigned char *bytes;
+    int length;
+{
+    int i;
+    for (i = 1; i < length; i++)
+        if (!IS_CONTINUATION(bytes[i]))
+            return False;
+    switch (bytes[0]) {
+        case 0xE0:
+            return bytes[1] >= 0xA0;    /* overlong 3-byte form */
+        case 0xED:
+            return bytes[1] < 0xA0;     /* surrogate */
+        case 0xF0:
+            return bytes[1] >= 0x90;    /* overlong 4-byte form */
+        case 0xF4:
+            return bytes[1] < 0x90;     /* beyond U+10FFFF */
+    }
+    return True;
+}
+/**********************************************************************/
+
+#ifdef X86_SIMD
+
+/*
+ * The copiers copy whole blocks of ASCII that do not contain the marker
+ * byte, widening each byte to the width of the text, and return the number
+ * of bytes copied.
+ */
+#define SSE2_ASCII_BLOCK(block, marks) \
+    (_mm_movemask_epi8(_mm_or_si128((block), \
+                       _mm_cmpeq_epi8((block), (marks)))) == 0)
+
+TARGET("sse2")
+static long copy_ascii_sse2_1(bytes, length, value, marker)
+    unsigned char *bytes;
+    long length;
+    void *value;
+    int marker;
+{
+    uint8_t *out = value;
+    long i;
+    __m128i block, marks;
+    marks = _mm_set1_epi8((char) marker);
+    for (i = 0; i + 16 <= length; i += 16)
+    {
+        block = _mm_loadu_si128((__m128i *) &bytes[i]);
+        if (!SSE2_ASCII_BLOCK(block, marks))
+            break;
+        _mm_storeu_si128((__m128i *) &out[i], block);
+    }
+    return i;
+}
+
+TARGET("sse2")
+static long copy_ascii_sse2_2(bytes, length, value, marker)
+    unsigned char *bytes;
+    long length;
+    void *value;
+    int marker;
+{
+    uint16_t *out = value;
+    long i;
+    __m128i block, zero, marks;
+    zero  = _mm_setzero_si128();
+    marks = _mm_set1_epi8((char) marker);
+    for (i = 0; i + 16 <= length; i += 16)
+    {
+        block = _mm_loadu_si128((__m128i *) &bytes[i]);
+        if (!SSE2_ASCII_BLOCK(block, marks))
+            break;
+        _mm_storeu_si128((__m128i *) &out[i], _mm_unpacklo_epi8(block, zero));
+        _mm_storeu_si128((__m128i *) &out[i + 8],
+                         _mm_unpackhi_epi8(block, zero));
+    }
+    return i;
+}
+
+TARGET("sse2")
+static long copy_ascii_sse2_4(bytes, length, value, marker)
+    unsigned char *bytes;
+    long length;
+    void *value;
+    int marker;
+{
+    Charvalue *out = value;
+    long i;
+    __m128i block, low, high, zero, marks;
+    zero  = _mm_setzero_si128();
+    marks = _mm_set1_epi8((char) marker);
+    for (i = 0; i + 16 <= length; i += 16)
+    {
+        block = _mm_loadu_si128((__m128i *) &bytes[i]);
+        if (!SSE2_ASCII_BLOCK(block, marks))
+            break;
+        low  = _mm_unpacklo_epi8(block, zero);
+        high = _mm_unpackhi_epi8(block, zero);
+        _mm_storeu_si128((__m128i *) &out[i], _mm_unpacklo_epi16(low, zero));
+        _mm_storeu_si128((__m128i *) &out[i + 4],
+                         _mm_unpackhi_epi16(low, zero));
+        _mm_storeu_si128((__m128i *) &out[i + 8],
+                         _mm_unpacklo_epi16(high, zero));
+        _mm_storeu_si128((__m128i *) &out[i + 12],
+                         _mm_unpackhi_epi16(high, zero));
+    }
+    return i;
+}
+/**********************************************************************/
+
+/* As the SSE2 copiers, but with 32-byte blocks. */
+#define AVX2_ASCII_BLOCK(block, marks) \
+    (_mm256_movemask_epi8(_mm256_or_si256((block), \
+                          _mm256_cmpeq_epi8((block), (marks)))) == 0)
+
+TARGET("avx2")
+static long copy_ascii_avx2_1(bytes, length, value, marker)
+    unsigned char *bytes;
+    long length;
+    void *value;
+    int marker;
+{
+    uint8_t *out = value;
+    long i;
+    __m256i block, marks;
+    marks = _mm256_set1_epi8((char) marker);
+    for (i = 0; i + 32 <= length; i += 32)
+    {
+        block = _mm256_loadu_si256((__m256i *) &bytes[i]);
+        if (!AVX2_ASCII_BLOCK(block, marks))
+            break;
+        _mm256_storeu_si256((__m256i *) &out[i], block);
+    }
+    return i;
+}
+
+TARGET("avx2")
+static long copy_ascii_avx2_2(bytes, length, value, marker)
+    unsigned char *bytes;
+    long length;
+    void *value;
+    int marker;
+{
+    uint16_t *out = value;
+    long i;
+    __m256i block, marks;
+    marks = _mm256_set1_epi8((char) marker);
+    for (i = 0; i + 32 <= length; i += 32)
+    {
+        block = _mm256_loadu_si256((__m256i *) &bytes[i]);
+        if (!AVX2_ASCII_BLOCK(block, marks))
+            break;
+        _mm256_storeu_si256((__m256i *) &out[i], _mm256_cvtepu8_epi16(
+                _mm_loadu_si128((__m128i *) &bytes[i])));
+        _mm256_storeu_si256((__m256i *) &out[i + 16], _mm256_cvtepu8_epi16(
+                _mm_loadu_si128((__m128i *) &bytes[i + 16])));
+    }
+    return i;
+}
+
+TARGET("avx2")
+static long copy_ascii_avx2_4(bytes, length, value, marker)
+    unsigned char *bytes;
+    long length;
+    void *value;
+    int marker;
+{
+    Charvalue *out = value;
+    long i;
+    __m256i block, marks;
+    marks = _mm256_set1_epi8((char) marker);
+    for (i = 0; i + 32 <= length; i += 32)
+    {
+        block = _mm256_loadu_si256((__m256i *) &bytes[i]);
+        if (!AVX2_ASCII_BLOCK(block, marks))
+            break;
+        _mm256_storeu_si256((__m256i *) &out[i], _mm256_cvtepu8_epi32(
+                _mm_loadl_epi64((__m128i *) &bytes[i])));
+        _mm256_storeu_si256((__m256i *) &out[i + 8], _mm256_cvtepu8_epi32(
+                _mm_loadl_epi64((__m128i *) &bytes[i + 8])));
+        _mm256_storeu_si256((__m256i *) &out[i + 16], _mm256_cvtepu8_epi32(
+                _mm_loadl_epi64((__m128i *) &bytes[i + 16])));
+        _mm256_storeu_si256((__m256i *) &out[i + 24], _mm256_cvtepu8_epi32(
+                _mm_loadl_epi64((__m128i *) &bytes[i + 24])));
+    }
+    return i;
+}
+/**********************************************************************/
+
+/*
+ * Error classes of the lookup algorithm of Keiser and Lemire, "Validating
+ * UTF-8 In Less Than One Instruction Per Byte" (2021). Each pair of
+ * adjacent bytes is classified by three table lookups (high and low nibble
+ * of the first byte, high nibble of the second); a bit that survives in all
+ * three identifies an error.
+ */
+#define TOO_SHORT       (1 << 0)    /* lead byte not followed by a
+                                       continuation byte */
+#define TOO_LONG        (1 << 1)    /* ASCII followed by a continuation */
+#define OVERLONG_3      (1 << 2)
+#define TOO_LARGE       (1 << 3)
+#define SURROGATE       (1 << 4)
+#define OVERLONG_2      (1 << 5)
+#define TOO_LARGE_1000  (1 << 6)
+#define OVERLONG_4      (1 << 6)
+#define TWO_CONTS       ((char) (1 << 7))
+                                    /* continuation after continuation; a
+                                       char, as are the table entries */
+#define CARRY           (TOO_SHORT | TOO_LONG | TWO_CONTS)
+
+/* Byte "input" shifted right by "n" bytes, with "previous" shifted in. */
+#define PREVIOUS(input, previous, n) \
+    _mm256_alignr_epi8((input), \
+        _mm256_permute2x128_si256((previous), (input), 0x21), 16 - (n))
+
+#define HIGH_NIBBLE(input) \
+    _mm256_and_si256(_mm256_srli_epi16((input), 4), _mm256_set1_epi8(0x0F))
+
+TARGET("avx2")
+static __m256i lookup(table, index)
+    __m256i table, index;
+{
+    return _mm256_shuffle_epi8(table, index);
+}
+
+TARGET("avx2")
+static __m256i check_block(input, previous)
+    __m256i input, previous;
+{
+    __m256i prev1, prev2, prev3, byte_1_high, byte_1_low, byte_2_high;
+    __m256i special, must_continue;
+    prev1 = PREVIOUS(input, previous, 1);
+    byte_1_high = lookup(_mm256_setr_epi8(
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+        TOO_SHORT | OVERLONG_2,
+        TOO_SHORT,
+        TOO_SHORT | OVERLONG_3 | SURROGATE,
+        TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4,
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+        TOO_SHORT | OVERLONG_2,
+        TOO_SHORT,
+        TOO_SHORT | OVERLONG_3 | SURROGATE,
+        TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4),
+        HIGH_NIBBLE(prev1));
+    byte_1_low = lookup(_mm256_setr_epi8(
+        CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+        CARRY | OVERLONG_2,
+        CARRY,
+        CARRY,
+        CARRY | TOO_LARGE,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+        CARRY | OVERLONG_2,
+        CARRY,
+        CARRY,
+        CARRY | TOO_LARGE,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000),
+        _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)));
+    byte_2_high = lookup(_mm256_setr_epi8(
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 |
+            OVERLONG_4,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 |
+            OVERLONG_4,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT),
+        HIGH_NIBBLE(input));
+    special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low),
+                               byte_2_high);
+    /* The third and fourth bytes of 3- and 4-byte sequences must be
+     * continuations; these are exactly the TWO_CONTS cases that are not
+     * errors. */
+    prev2 = PREVIOUS(input, previous, 2);
+    prev3 = PREVIOUS(input, previous, 3);
+    must_continue = _mm256_and_si256(_mm256_or_si256(
+        _mm256_subs_epu8(prev2, _mm256_set1_epi8((char) (0xE0 - 0x80))),
+        _mm256_subs_epu8(prev3, _mm256_set1_epi8((char) (0xF0 - 0x80)))),
+        _mm256_set1_epi8((char) 0x80));
+    return _mm256_xor_si256(must_continue, special);
+}
+/**********************************************************************/
+
+/* Returns True if the "length" bytes at "bytes" are valid UTF-8. */
+TARGET("avx2")
+static Boolean validate_avx2(bytes, length)
+    unsigned char *bytes;
+    long length;
+{
+    long i;
+    unsigned char tail[32];
+    __m256i input, previous, errors, incomplete, max_value;
+    previous = errors = incomplete = _mm256_setzero_si256();
+    /* Bytes in the last three positions that begin a sequence too long to
+     * end within the block. */
+    max_value = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        (char) (0xF0 - 1), (char) (0xE0 - 1), (char) (0xC0 - 1));
+    for (i = 0; i <= length; i += 32)
+    {
+        if (i + 32 <= length)
+            input = _mm256_loadu_si256((__m256i *) &bytes[i]);
+        else
+        {
+            /* Pad the last block with ASCII, which also flags a sequence
+             * left incomplete at the very end. */
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, &bytes[i], length - i);
+            input = _mm256_loadu_si256((__m256i *) tail);
+        }
+        if (_mm256_movemask_epi8(input) == 0)
+            errors = _mm256_or_si256(errors, incomplete);
+        else
+        {
+            errors = _mm256_or_si256(errors, check_block(input, previous));
+            incomplete = _mm256_subs_epu8(input, max_value);
+        }
+        previous = input;
+    }
+    return(_mm256_testz_si256(errors, errors) ? True : False);
+}
+
+#endif
+/**********************************************************************/
+
+static void initialize_decoder()
+{
+#ifdef X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2"))
+    {
+        copy_ascii[0] = copy_ascii_sse2_1;
+        copy_ascii[1] = copy_ascii_sse2_2;
+        copy_ascii[2] = copy_ascii_sse2_4;
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        copy_ascii[0] = copy_ascii_avx2_1;
+        copy_ascii[1] = copy_ascii_avx2_2;
+        copy_ascii[2] = copy_ascii_avx2_4;
+        use_avx2 = True;
+    }
+#endif
+    initialized = True;
+}
+/**********************************************************************/
+
+void decoder_initialize(decoder, text, find_markers, suspect_marker)
+    Decoder *decoder;
+    Text *text;
+    Boolean find_markers;
+    Charvalue suspect_marker;
+{
+    if (!initialized)
+        initialize_decoder();
+    decoder->text = text;
+    decoder->find_markers = find_markers;
+    decoder->suspect_marker = suspect_marker;
+    decoder->suspect = False;
+    decoder->offset = 0;
+}
+/**********************************************************************/
+
+static long find_invalid_scalar(bytes, length)
+    unsigned char *bytes;
+    long length;
+{
+    long i = 0;
+    int n;
+    while (i < length)
+    {
+        n = sequence_length(bytes[i]);
+        if (n == 0 || i + n > length || !valid_sequence(&bytes[i], n))
+            return(i);
+        i += n;
+    }
+    return(-1);
+}
+/**********************************************************************/
+
+long find_invalid_utf8(bytes, length)
+    unsigned char *bytes;
+    long length;
+{
+    if (!initialized)
+        initialize_decoder();
+#ifdef X86_SIMD
+    if (use_avx2 && validate_avx2(bytes, length))
+        return(-1);
+#endif
+    return(find_invalid_scalar(bytes, length));
+}
+/**********************************************************************/
+
+static void report_invalid(offset)
+    long offset;
+{
+    char message[100];
+    sprintf(message, "invalid UTF-8 sequence at byte %ld", offset);
+    error(message);
+}
+/**********************************************************************/
+
+/*
+ * Returns the length of the longest prefix of the block that does not end
+ * with an incomplete sequence.
+ */
+static long complete_length(bytes, length)
+    unsigned char *bytes;
+    long length;
+{
+    long i;
+    int n;
+    for (i = length - 1; i >= 0 && i >= length - 3; i--)
+        if (!IS_CONTINUATION(bytes[i]))
+        {
+            n = sequence_length(bytes[i]);
+            return(n > 0 && i + n > length ? i : length);
+        }
+    return(length);
+}
+/**********************************************************************/
+
+long decode_utf8(decoder, bytes, length, final)
+    Decoder *decoder;
+    unsigned char *bytes;
+    long length;
+    Boolean final;
+{
+    Text *text = decoder->text;
+    Charvalue value, marker = decoder->suspect_marker;
+    Boolean find_markers = decoder->find_markers, checked = True;
+    long i = 0, copied;
+    int n, ascii_marker;
+
+    if (!final)
+        length = complete_length(bytes, length);
+    /* Each byte decodes to at most one character. */
+    reserve_text(text, text->count + length);
+    /* An ASCII block containing the suspect marker is decoded by the
+     * slow path; a byte value above 0x7F never occurs in an ASCII block. */
+    ascii_marker = (find_markers && marker < 0x80 ? (int) marker : 0x80);
+#ifdef X86_SIMD
+    if (use_avx2)
+    {
+        if (!validate_avx2(bytes, length))
+            report_invalid(decoder->offset + find_invalid_scalar(bytes,
+                                                                 length));
+        checked = False;
+    }
+#endif
+
+    while (i < length)
+    {
+        if (bytes[i] < 0x80 && !decoder->suspect &&
+            copy_ascii[text->width >> 1])
+        {
+            copied = (*copy_ascii[text->width >> 1])(&bytes[i], length - i,
+                (char *) text->value.any + text->count * text->width,
+                ascii_marker);
+            if (copied > 0)
+            {
+                text->count += copied;
+                i += copied;
+                continue;
+            }
+        }
+        if (bytes[i] < 0x80)
+        {
+            n = 1;
+            value = bytes[i];
+        }
+        else
+        {
+            n = sequence_length(bytes[i]);
+            if (checked && (n == 0 || i + n > length ||
+                            !valid_sequence(&bytes[i], n)))
+                report_invalid(decoder->offset + i);
+            value = decode_sequence(&bytes[i], n);
+        }
+        i += n;
+
+        if (find_markers && value == marker)
+            decoder->suspect = True;
+        else
+        {
+            if (decoder->suspect)
+            {
+                set_suspect(text, text->count, True);
+                decoder->suspect = False;
+            }
+            set_value(text, text->count++, value);
+        }
+    }
+    decoder->offset += length;
+    return(length);
+}
@@ -0,0 +1,71 @@
+/**********************************************************************
+ *
+ *  utf8.h
+ *
+ *  This module provides a bulk UTF-8 decoder.  Input is decoded a block
+ *  of bytes at a time rather than a character at a time: runs of ASCII
+ *  are copied 16 or 32 bytes at a time using SSE2 or AVX2, and on
+ *  processors with AVX2, whole blocks are validated before decoding.  The
+ *  instruction set is selected at run time; a scalar decoder is used on
+ *  all other processors.
+ *
+ *  Decoding is strict: overlong forms, surrogates and values beyond
+ *  U+10FFFF are rejected, and the byte offset of the first invalid
+ *  sequence is reported.
+ *
+ * Copyright 2026 ocreval contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You
+ * may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ *
+ **********************************************************************/
+
+#ifndef _UTF8_
+#define _UTF8_
+
+#include "text.h"
+
+typedef
+struct
+{
+    Text *text;         /* text to which decoded characters are appended */
+    Boolean find_markers;
+                        /* if True, the suspect marker is not appended, but
+                           marks the following character as suspect */
+    Charvalue suspect_marker;
+                        /* applicable when "find_markers" is True */
+    Boolean suspect;    /* True if the last character decoded was a suspect
+                           marker */
+    long offset;        /* byte offset of the next byte to be decoded, used
+                           when reporting an invalid sequence */
+} Decoder;
+
+void decoder_initialize(/* Decoder *decoder, Text *text,
+                           Boolean find_markers, Charvalue suspect_marker */);
+                        /* prepares "decoder" to append characters to "text" */
+
+long decode_utf8(/* Decoder *decoder, unsigned char *bytes, long length,
+                    Boolean final */);
+                        /* decodes the given block of bytes and appends each
+                           character to the decoder's text; if "final" is
+                           False, an incomplete sequence at the end of the
+                           block is left undecoded, so that it may be passed
+                           again with the bytes that follow it; returns the
+                           number of bytes decoded; reports an error and
+                           quits if an invalid sequence is found */
+
+long find_invalid_utf8(/* unsigned char *bytes, long length */);
+                        /* returns the byte offset of the first invalid or
+                           incomplete sequence in "bytes", or -1 if all
+                           "length" bytes are valid UTF-8 */
+
+#endif
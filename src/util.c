@@ -27,6 +27,7 @@
 #if defined(__unix__) || defined(__MACH__)
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #else
 #include <sys\types.h>
 #include <sys\stat.h>
@@ -48,17 +49,6 @@ static void quit(/* int status */) __attribute__ ((noreturn));
 
 /**********************************************************************/
 
-void *allocate(number, size)
-size_t number, size;
-{
-    void *p;
-    p = calloc(number, size);
-    if (!p)
-	error("unable to allocate memory");
-    return(p);
-}
-/**********************************************************************/
-
 int ustrcmp(s1, s2)
 unsigned char *s1, *s2;
 {
@@ -75,7 +65,7 @@ FILE *open_file(filename, mode)
 char *filename, *mode;
 {
     FILE *f;
-    if (!filename)
+    if (!filename || strcmp(filename, "-") == 0)
 	return(mode[0] == 'r' ? stdin : stdout);
     f = fopen(filename, mode);
     if (f)
@@ -95,6 +85,34 @@ FILE *f;
 }
 /**********************************************************************/
 
+gzFile open_gzfile(filename)
+char *filename;
+{
+    gzFile f;
+    int fd;
+    if (!filename || strcmp(filename, "-") == 0)
+    {
+	/* Duplicate stdin, so that it stays open when the file is closed. */
+	fd = dup(fileno(stdin));
+	f = (fd >= 0 ? gzdopen(fd, "rb") : NULL);
+	if (f)
+	    return(f);
+	error_string("unable to open file", "stdin");
+    }
+    f = gzopen(filename, "rb");
+    if (f)
+	return(f);
+    error_string("unable to open file", filename);
+}
+/**********************************************************************/
+
+void close_gzfile(f)
+gzFile f;
+{
+    gzclose(f);
+}
+/**********************************************************************/
+
 Boolean file_exists(filename)
 char *filename;
 {
@@ -246,6 +264,22 @@ Option option[];
 }
 /**********************************************************************/
 
+long option_value(string, default_value, minimum, maximum, message)
+char *string;
+long default_value, minimum, maximum;
+char *message;
+{
+    long value;
+    char extra;
+    if (!string)
+	return(default_value);
+    if (sscanf(string, "%ld%c", &value, &extra) == 1 && value >= minimum &&
+    value <= maximum)
+	return(value);
+    error_string(message, string);
+}
+/**********************************************************************/
+
 static void quit(status)
 int status;
 {
@@ -262,6 +296,13 @@ void terminate()
 }
 /**********************************************************************/
 
+void terminate_status(status)
+int status;
+{
+    quit(status);
+}
+/**********************************************************************/
+
 void error(message)
 char *message;
 {
@@ -32,6 +32,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <zlib.h>
 
 #ifndef unix
 /* On Linux and Mac OS X */
@@ -57,6 +58,42 @@ typedef char Boolean;
                    ((type *) allocate((size_t) (number), sizeof(type)))
 			/* allocate an array of "type" */
 void *allocate(/* size_t number, size_t size */);
+			/* returns zeroed memory for "number" objects of
+			   "size" bytes, taken from the current arena if there
+			   is one, else from the heap; reports an error and
+			   quits if none is available */
+
+#define DISPOSE(pointer, type)  deallocate((void *) (pointer), sizeof(type))
+			/* release an instance of "type" obtained from NEW */
+#define DISPOSE_ARRAY(pointer)  deallocate((void *) (pointer), (size_t) 0)
+			/* release an array obtained from NEW_ARRAY */
+void deallocate(/* void *pointer, size_t size */);
+			/* releases memory obtained from "allocate"; if it was
+			   taken from an arena, it is kept by the arena, and if
+			   that arena is current in the calling thread, an
+			   object of a small "size" is reused by a later
+			   allocation of the same size; "size" is 0 for an
+			   array; does nothing if "pointer" is NULL */
+
+typedef struct arena Arena;
+
+Arena *new_arena();	/* creates an empty arena, from which memory is taken
+			   in large chunks and released all at once */
+
+Arena *use_arena(/* Arena *arena */);
+			/* makes "arena" the current arena of the calling
+			   thread, from which "NEW" and "NEW_ARRAY" take memory
+			   in that thread until the next call; if "arena" is
+			   NULL, they take memory from the heap, as they do in
+			   a thread that has not called it; returns the
+			   previous current arena; an arena may be current in
+			   only one thread at a time */
+
+void free_arena(/* Arena *arena */);
+			/* releases all the memory taken from "arena", and the
+			   arena itself; if it is current, the heap becomes
+			   current; no memory taken from it may be used or
+			   released afterward */
 
 int ustrcmp(/* unsigned char *s1, unsigned char *s2 */);
 			/* compares strings like "strcmp" but treats characters
@@ -65,12 +102,21 @@ int ustrcmp(/* unsigned char *s1, unsigned char *s2 */);
 FILE *open_file(/* char *filename, char *mode */);
 			/* opens the named file in the specified mode; reports
 			   an error and quits if unable to open the file; if
-			   "filename" is NULL, returns stdin or stdout,
+			   "filename" is NULL or "-", returns stdin or stdout,
 			   depending on the mode */
 
 void close_file(/* FILE *f */);
 			/* closes the specified file */
 
+gzFile open_gzfile(/* char *filename */);
+			/* opens the named file for reading, decompressing it
+			   if it is gzip-compressed; reports an error and quits
+			   if unable to open the file; if "filename" is NULL or
+			   "-", reads from stdin */
+
+void close_gzfile(/* gzFile f */);
+			/* closes the specified file */
+
 Boolean file_exists(/* char *filename */);
 			/* returns True if the named file exists */
 
@@ -121,9 +167,20 @@ void initialize(/* int *argc, char *argv[], char *usage, Option option[] */);
 			   has been set; "option" may be NULL if there are no
 			   options */
 
+long option_value(/* char *string, long default_value, long minimum,
+		     long maximum, char *message */);
+			/* returns the number given as the value "string" of
+			   a string-valued option, or "default_value" if
+			   "string" is NULL; reports "message" and quits if it
+			   is not a number from "minimum" to "maximum" */
+
 void terminate()	/* terminates the program with exit status 0 */
     __attribute__ ((noreturn));
 
+void terminate_status(/* int status */)
+    __attribute__ ((noreturn));
+			/* terminates the program with exit status "status" */
+
 extern int errstatus;	/* status returned when exiting due to an error; this is
 			   1 by default */
 
@@ -26,17 +26,19 @@
 #include "sync.h"
 #include "table.h"
 
-#define usage  "[-O] [-o outputfile] [-s m/n] [-w m/n] textfile1 textfile2 ..."
+#define usage  "[-c] [-O] [-o outputfile] [-s m/n] [-t threads] [-w m/n] textfile1 textfile2 ..."
 
-Boolean debug, optimize;
-char *outputfilename, *sfraction, *wfraction;
+Boolean center, debug, optimize;
+char *outputfilename, *sfraction, *threadstring, *wfraction;
 
 Option option[] =
 {
+    'c', NULL,            &center,
     'D', NULL,            &debug,
     'O', NULL,            &optimize,
     'o', &outputfilename, NULL,
     's', &sfraction,      NULL,
+    't', &threadstring,   NULL,
     'w', &wfraction,      NULL,
     '\0'
 };
@@ -75,7 +77,7 @@ Text input[MAX_VOTERS], output;
 
 struct
 {
-    Char *c;
+    Charvalue value;
     short num_votes;
 } candidate[MAX_VOTERS];
 short num_candidates;
@@ -124,6 +126,8 @@ char *argv[];
 	else
 	    error_string("invalid threshold", sfraction);
     }
+    synchronize_threads = (short) option_value(threadstring, 1L, 1L,
+    (long) SYNC_MAX_THREADS, "invalid number of threads");
 }
 /**********************************************************************/
 
@@ -149,21 +153,22 @@ short index;
 void count_sequences(index)
 short index;
 {
-    Char *start, *c;
+    Text *text = &voter[index]->text;
+    long start, c;
     char key[N * STRING_SIZE], string[STRING_SIZE];
     Boolean reject;
     short i;
-    for (start = voter[index]->text.first; start; start = start->next)
+    for (start = 0; start < text->count; start++)
     {
 	key[0] = '\0';
 	reject = False;
-	for (i = 0, c = start; i < N; i++, c = c->next)
+	for (i = 0, c = start; i < N; i++, c++)
 	{
-	    if (!c)
+	    if (c >= text->count)
 		return;
-	    char_to_string(False, c->value, string, False);
+	    char_to_string(False, TEXT_VALUE(text, c), string, False);
 	    strcat(key, string);
-	    if (c->value == REJECT_CHARACTER)
+	    if (TEXT_VALUE(text, c) == REJECT_CHARACTER)
 		reject = True;
 	}
 	add_sequence(key, reject, index);
@@ -243,28 +248,28 @@ void select_voters()
 }
 /**********************************************************************/
 
-void place_vote(c)
-Char *c;
+void place_vote(text, index)
+Text *text;
+long index;
 {
     short num_votes, i;
+    Charvalue value = INVALID_CHARVALUE;
     num_votes = unmarked_weight;
-    if (c)
+    if (text)
     {
-	if (c->value == REJECT_CHARACTER)
+	value = TEXT_VALUE(text, index);
+	if (value == REJECT_CHARACTER)
 	    return;
-	if (c->suspect)
+	if (TEXT_SUSPECT(text, index))
 	    num_votes = suspect_weight;
-	for (i = 0; i < num_candidates && (!candidate[i].c ||
-	c->value != candidate[i].c->value); i++);
     }
-    else
-	for (i = 0; i < num_candidates && candidate[i].c; i++);
+    for (i = 0; i < num_candidates && value != candidate[i].value; i++);
     if (i < num_candidates)
 	candidate[i].num_votes += num_votes;
     else
     {
 	num_candidates++;
-	candidate[i].c = c;
+	candidate[i].value = value;
 	candidate[i].num_votes = num_votes;
     }
 }
@@ -282,28 +287,32 @@ Boolean winner()
 	if (candidate[i].num_votes > candidate[leader].num_votes)
 	    leader = i;
     num_candidates = 0;
-    if (!candidate[leader].c)
+    if (candidate[leader].value == INVALID_CHARVALUE)
 	return(False);
     append_char(&output,
     (candidate[leader].num_votes <= suspect_threshold ? True : False),
-    candidate[leader].c->value);
+    candidate[leader].value);
     return(True);
 }
 /**********************************************************************/
 
-void perform_vote(synclist)
-Synclist *synclist;
+void perform_vote(array)
+Syncarray *array;
 {
-    Sync *sync;
+    long position[SYNC_MAX_STREAMS], k;
     short i;
-    for (sync = synclist->first; sync; sync = sync->next)
+    for (k = 0; k < array->count; k++)
+    {
+	for (i = 0; i < actual_voters; i++)
+	    position[i] = array->start[i][k];
 	do
 	    for (i = 0; i < actual_voters; i++)
-		if (sync->substr[i].start <= sync->substr[i].stop)
-		    place_vote(input[i].array[sync->substr[i].start++]);
+		if (position[i] <= array->stop[i][k])
+		    place_vote(&input[i], position[i]++);
 		else
-		    place_vote(NULL);
+		    place_vote(NULL, 0L);
 	while (winner());
+    }
 }
 /**********************************************************************/
 
@@ -311,12 +320,16 @@ main(argc, argv)
 int argc;
 char *argv[];
 {
-    Synclist synclist;
+    Syncarray array;
     initialize(&argc, argv, usage, option);
     validate_args(argc, argv);
     select_voters();
-    synchronize(&synclist, actual_voters, input);
-    perform_vote(&synclist);
+    /* With optimization, the voters are in order of distance. */
+    if (center)
+	center_sync(&array, actual_voters, input, (short) (optimize ? 0 : -1));
+    else
+	synchronize_array(&array, actual_voters, input);
+    perform_vote(&array);
     write_text(&output, outputfilename, NULL);
     terminate();
 }
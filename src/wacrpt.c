@@ -24,6 +24,7 @@
 
 #include "sort.h"
 #include "wacrpt.h"
+#include "output.h"
 #include "ocreval_version.h"
 
 #define TITLE    "ocreval Word Accuracy Report Version " OCREVAL_VERSION "\n"
@@ -63,14 +64,14 @@ long count, missed;
 /**********************************************************************/
 
 static Boolean read_line(f)
-FILE *f;
+gzFile f;
 {
-    return(fgets(line, sizeof(line) - 1, f) ? True : False);
+    return(gzgets(f, line, sizeof(line) - 1) ? True : False);
 }
 /**********************************************************************/
 
 static Boolean read_one(f, value)
-FILE *f;
+gzFile f;
 long *value;
 {
     return(read_line(f) && sscanf(line, "%ld", value) == 1 ? True : False);
@@ -78,7 +79,7 @@ long *value;
 /**********************************************************************/
 
 static Boolean read_two(f, value1, value2)
-FILE *f;
+gzFile f;
 long *value1, *value2;
 {
     return(read_line(f) && sscanf(line, "%ld %ld", value1, value2) == 2 ?
@@ -87,7 +88,7 @@ long *value1, *value2;
 /**********************************************************************/
 
 static long read_numbers(f, wac)
-FILE *f;
+gzFile f;
 Wac wac[];
 {
     long count, missed, index, total_count = 0;
@@ -108,7 +109,7 @@ Wac wac[];
 /**********************************************************************/
 
 static void read_terms(f, termtable)
-FILE *f;
+gzFile f;
 Termtable *termtable;
 {
     long count, missed;
@@ -125,9 +126,9 @@ void read_wacrpt(wacdata, filename)
 Wacdata *wacdata;
 char *filename;
 {
-    FILE *f;
+    gzFile f;
     long words, missed, stopwords, non_stopwords;
-    f = open_file(filename, "r");
+    f = open_gzfile(filename);
     if (read_line(f) && strncmp(line, TITLE, sizeof(TITLE) - 3) == 0 &&
     read_line(f) && strcmp(line, DIVIDER) == 0 &&
     read_one(f, &words) && read_one(f, &missed) &&
@@ -148,62 +149,80 @@ char *filename;
     }
     else
 	error_string("invalid format in", (filename ? filename : "stdin"));
-    close_file(f);
+    close_gzfile(f);
 }
 /**********************************************************************/
 
-static void write_pct(f, wac)
-FILE *f;
+static void write_pct(output, wac)
+Output *output;
 Wac *wac;
 {
     if (wac->count == 0)
-	fputs("  ------", f);
+	output_string(output, "  ------");
     else
-	fprintf(f, "%8.2f", 100.0 * (wac->count - wac->missed) / wac->count);
+	output_fixed(output, 100.0 * (wac->count - wac->missed) / wac->count,
+	8, 2);
 }
 /**********************************************************************/
 
-static void write_wac(f, wac)
-FILE *f;
+static void write_wac(output, wac)
+Output *output;
 Wac *wac;
 {
     if (wac)
     {
-	fprintf(f, "%8ld %8ld ", wac->count, wac->missed);
-	write_pct(f, wac);
+	output_long(output, wac->count, 8);
+	OUTPUT_BYTE(output, ' ');
+	output_long(output, wac->missed, 8);
+	OUTPUT_BYTE(output, ' ');
+	write_pct(output, wac);
     }
     else
-	fputs("   Count   Missed   %Right", f);
-    fputs("   ", f);
+	output_string(output, "   Count   Missed   %Right");
+    output_string(output, "   ");
 }
 /**********************************************************************/
 
-static void write_numbers(f, wac, limit, title, excess, total)
-FILE *f;
+static void write_title(output, title)
+Output *output;
+char *title;
+{
+    OUTPUT_BYTE(output, '\n');
+    output_string(output, title);
+    OUTPUT_BYTE(output, '\n');
+}
+/**********************************************************************/
+
+static void write_numbers(output, wac, limit, title, excess, total)
+Output *output;
 Wac wac[];
 short limit;
 char *title;
 Boolean excess, total;
 {
     short i;
-    fprintf(f, "\n%s\n", title);
-    write_wac(f, NULL);
-    fprintf(f, "%s\n", (excess ? "Occurs" : "Length"));
+    write_title(output, title);
+    write_wac(output, NULL);
+    output_string(output, (excess ? "Occurs\n" : "Length\n"));
     for (i = 1; i <= limit; i++)
 	if (wac[i].count > 0)
 	{
-	    write_wac(f, &wac[i]);
-	    fprintf(f, "    %2d\n", i);
+	    write_wac(output, &wac[i]);
+	    output_string(output, "    ");
+	    output_long(output, (long) i, 2);
+	    OUTPUT_BYTE(output, '\n');
 	}
     if (excess && wac[limit + 1].count > 0)
     {
-	write_wac(f, &wac[limit + 1]);
-	fprintf(f, "   >%2d\n", limit);
+	write_wac(output, &wac[limit + 1]);
+	output_string(output, "   >");
+	output_long(output, (long) limit, 2);
+	OUTPUT_BYTE(output, '\n');
     }
     if (total)
     {
-	write_wac(f, &wac[0]);
-	fputs(TOTAL, f);
+	write_wac(output, &wac[0]);
+	output_string(output, TOTAL);
     }
 }
 /**********************************************************************/
@@ -215,21 +234,22 @@ Term *term1, *term2;
 }
 /**********************************************************************/
 
-static void write_terms(f, termtable, title)
-FILE *f;
+static void write_terms(output, termtable, title)
+Output *output;
 Termtable *termtable;
 char *title;
 {
     long i;
     table_in_array(termtable);
     sort(termtable->count, termtable->array, compare_term);
-    fprintf(f, "\n%s\n", title);
-    write_wac(f, NULL);
-    fputc('\n', f);
+    write_title(output, title);
+    write_wac(output, NULL);
+    OUTPUT_BYTE(output, '\n');
     for (i = 0; i < termtable->count; i++)
     {
-	write_wac(f, &termtable->array[i]->wac);
-	fprintf(f, "%s\n", termtable->array[i]->key);
+	write_wac(output, &termtable->array[i]->wac);
+	output_string(output, termtable->array[i]->key);
+	OUTPUT_BYTE(output, '\n');
     }
 }
 /**********************************************************************/
@@ -238,27 +258,47 @@ void write_wacrpt(wacdata, filename)
 Wacdata *wacdata;
 char *filename;
 {
-    FILE *f;
-    f = open_file(filename, "w");
-    fprintf(f, "%s%s", TITLE, DIVIDER);
-    fprintf(f, "%8ld   Words\n", wacdata->total.count);
-    fprintf(f, "%8ld   Misrecognized\n", wacdata->total.missed);
-    write_pct(f, &wacdata->total);
-    fputs("%  Accuracy\n", f);
-    write_numbers(f, wacdata->stopword, MAX_WORDLENGTH,
+    Output output;
+    open_output(&output, filename);
+    output_string(&output, TITLE);
+    output_string(&output, DIVIDER);
+    output_long(&output, wacdata->total.count, 8);
+    output_string(&output, "   Words\n");
+    output_long(&output, wacdata->total.missed, 8);
+    output_string(&output, "   Misrecognized\n");
+    write_pct(&output, &wacdata->total);
+    output_string(&output, "%  Accuracy\n");
+    write_numbers(&output, wacdata->stopword, MAX_WORDLENGTH,
     "Stopwords", False, True);
-    write_numbers(f, wacdata->non_stopword, MAX_WORDLENGTH,
+    write_numbers(&output, wacdata->non_stopword, MAX_WORDLENGTH,
     "Non-stopwords", False, True);
-    write_numbers(f, wacdata->distinct_non_stopword, MAX_OCCURRENCES,
+    write_numbers(&output, wacdata->distinct_non_stopword, MAX_OCCURRENCES,
     "Distinct Non-stopwords", True, True);
     if (wacdata->total.count > 0)
     {
-	write_numbers(f, wacdata->phrase, MAX_PHRASELENGTH,
+	write_numbers(&output, wacdata->phrase, MAX_PHRASELENGTH,
 	"Phrases", False, False);
 	if (wacdata->stopword[0].count > 0)
-	    write_terms(f, &wacdata->stopword_table, "Stopwords");
+	    write_terms(&output, &wacdata->stopword_table, "Stopwords");
 	if (wacdata->non_stopword[0].count > 0)
-	    write_terms(f, &wacdata->non_stopword_table, "Non-stopwords");
+	    write_terms(&output, &wacdata->non_stopword_table, "Non-stopwords");
     }
-    close_file(f);
+    close_output(&output);
+}
+/**********************************************************************/
+
+void write_exceeded_wacrpt(words, max_missed, filename)
+long words, max_missed;
+char *filename;
+{
+    Output output;
+    open_output(&output, filename);
+    output_string(&output, TITLE);
+    output_string(&output, DIVIDER);
+    output_long(&output, words, 8);
+    output_string(&output, "   Words\n");
+    OUTPUT_BYTE(&output, '>');
+    output_long(&output, max_missed, 7);
+    output_string(&output, "   Misrecognized (threshold exceeded)\n");
+    close_output(&output);
 }
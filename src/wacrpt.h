@@ -84,14 +84,23 @@ void add_term(/* Termtable *termtable, char *key, long count, long missed */);
 			   a copy of this string is stored in the table */
 
 void read_wacrpt(/* Wacdata *wacdata, char *filename */);
-			/* reads the named file (or stdin if "filename" is NULL)
-			   and adds its contents to "wacdata"; reports an error
-			   and quits if unable to open the file, or if the file
-			   does not contain a word accuracy report */
+			/* reads the named file (or stdin if "filename" is NULL),
+			   which may be gzip-compressed, and adds its contents
+			   to "wacdata"; reports an error and quits if unable to
+			   open the file, or if the file does not contain
+			   a word accuracy report */
 
 void write_wacrpt(/* Wacdata *wacdata, char *filename */);
 			/* writes the contents of "wacdata" to the named file
 			   (or stdout if "filename" is NULL); reports an error
 			   and quits if unable to create the file */
 
+void write_exceeded_wacrpt(/* long words, long max_missed,
+                              char *filename */);
+			/* writes a short report to the named file (or stdout
+			   if "filename" is NULL) stating only that more than
+			   "max_missed" of the "words" ground-truth words were
+			   misrecognized; this report cannot be read by
+			   "read_wacrpt" */
+
 #endif
@@ -29,6 +29,7 @@
 #include <string.h>
 
 #include <utf8proc.h>
+#include "unicode.h"
 #include "word.h"
 
 #include "word_break_property.h"
@@ -42,123 +43,103 @@
 
 /**********************************************************************/
 
-/* Recursive binary search for the property. */
-static wb_property search_for_property(code_point, left, right)
-    Charvalue code_point;
-    int left, right;
-{
-
-    /* Not found, therefore not specified. */
-    if (right < left) {
-        return Other;
-    }
-
-    const size_t midpoint = left + (right - left) / 2;
-    const wb_range *middle = &WORD_BREAK_PROPERTY[midpoint];
-
-    if (code_point < middle->start) {
-        return search_for_property(code_point, left, midpoint - 1);
-    } else if (code_point > middle->end) {
-        return search_for_property(code_point, midpoint + 1, right);
-    } else {
-        assert(code_point >= middle->start && code_point <= middle->end);
-        return middle->value;
-    }
-}
-/**********************************************************************/
-
 /* Returns the word break property for a Unicode code point. */
-__attribute__ ((const))
-static wb_property property(code_point)
-    Charvalue code_point;
-{
-    const size_t len = sizeof(WORD_BREAK_PROPERTY) / sizeof(wb_range);
-    return search_for_property(code_point, 0, len - 1);
-}
-/**********************************************************************/
+#define property(code_point) \
+    ((wb_property) UNICODE_PROPERTY(code_point)->word_break)
 
+/* Returns the word break property of character i, or eot if i is past the
+ * end of the text. */
 __attribute__ ((pure))
-static wb_property char_property(node)
-    const Char *node;
+static wb_property char_property(text, i)
+    const Text *text;
+    long i;
 {
-    if (node == NULL) {
+    Charvalue value;
+    if (i >= text->count) {
         return eot;
     }
-    return property(node->value);
+    value = TEXT_VALUE(text, i);
+    return property(value);
 }
 
-/* Returns the next character, skipping Extend and Format characters.
+/* Returns the index of the next character, skipping Extend and Format
+ * characters; returns text->count at the end of the text.
  * WB4: Skip over Extend and Format characters.  */
 __attribute__ ((pure))
-static Char* skip_to_next(from)
-    Char *from;
+static long skip_to_next(text, from)
+    const Text *text;
+    long from;
 {
-    if (from == NULL) {
-        return NULL;
+    if (from >= text->count) {
+        return text->count;
     }
 
     do {
-        from = from->next;
-    } while (from != NULL && ExtendOrFormat(char_property(from)));
+        from++;
+    } while (from < text->count && ExtendOrFormat(char_property(text, from)));
     return from;
 }
 
 __attribute__ ((pure))
-static Char* skip_twice(from)
-    Char *from;
+static long skip_twice(text, from)
+    const Text *text;
+    long from;
 {
-    return skip_to_next(skip_to_next(from));
+    return skip_to_next(text, skip_to_next(text, from));
 }
 
 /* Returns the last code point of a grapheme, including extend and format
  * characters.  */
-static Char* skip_to_end_of_extend(from)
-    Char *from;
+static long skip_to_end_of_extend(text, from)
+    const Text *text;
+    long from;
 {
-    if (from == NULL) {
-        return NULL;
+    if (from >= text->count) {
+        return text->count;
     }
 
     /* Skip until the LAST extend or format character. */
-    while (from->next != NULL && ExtendOrFormat(char_property(from->next))) {
-        from = from->next;
+    while (from + 1 < text->count &&
+           ExtendOrFormat(char_property(text, from + 1))) {
+        from++;
     }
 
     return from;
 }
 
 /*
- * Returns the next Char* BEFORE the next boundary. Note that this may just
- * be the same character as was given.
+ * Returns the index of the character BEFORE the next boundary. Note that
+ * this may just be the same character as was given. Returns text->count if
+ * there are no more boundaries.
  *
  * Implements the Unicode TR29 Word Boundary Rules:
  * http://unicode.org/reports/tr29/#Word_Boundary_Rules
  */
-static Char* find_next_boundary(start)
-    Char *start;
+static long find_next_boundary(text, start)
+    const Text *text;
+    long start;
 {
-    /* The first thing the loop does is advance, so we need a dummy "start of
-     * loop" character that does not participate in the search. */
-    Char dummy;
-    dummy.next = start;
-    Char *current = &dummy;
+    /* The first thing the loop does is advance, so we start on a dummy
+     * "start of loop" position, just before "start", that does not
+     * participate in the search. */
+    long current = start - 1;
     wb_property left = sot, right, lookahead, lookbehind;
 
     /* WB1: Break at the start and end of text. */
-    if (start == NULL) {
-        return NULL;
+    if (start >= text->count) {
+        return text->count;
     }
 
     /* Loop to find the next word break. */
 
     /* WB2: Break at the start and end of text. */
-    while (current->next != NULL) {
+    while (current + 1 < text->count) {
         /* Advance all the pointers. */
-        current = skip_to_next(current);
+        current = skip_to_next(text, current);
         lookbehind = left;
-        left = char_property(current);
-        right = char_property(skip_to_next(current));
-        lookahead = char_property(skip_twice(current));
+        left = char_property(text, current);
+        right = char_property(text, skip_to_next(text, current));
+        lookahead = char_property(text, skip_twice(text, current));
 
         /* WB3: Do not break within CRLF. */
         if (left == CR && right == LF) continue;
@@ -235,22 +216,24 @@ static Char* find_next_boundary(start)
         break;
     }
 
-    return skip_to_end_of_extend(current);
+    return skip_to_end_of_extend(text, current);
 }
 /**********************************************************************/
 
-static size_t find_utf8_length(start, after)
-    const Char *start, *after;
+static size_t find_utf8_length(text, start, after)
+    const Text *text;
+    long start, after;
 {
-    const Char *current;
+    long current;
     size_t len = 0, encoded_length = 0;
     utf8proc_uint8_t dummy_buffer[4];
 
-    for (current = start; current != after; current = current->next) {
-        assert(current != NULL);
+    for (current = start; current != after; current++) {
+        assert(current < text->count);
         /* Do a dummy encoding of the character for the side-effect of
          * returning its length. */
-        encoded_length = utf8proc_encode_char(current->value, dummy_buffer);
+        encoded_length = utf8proc_encode_char(TEXT_VALUE(text, current),
+                                              dummy_buffer);
         assert(encoded_length > 0);
 
         len += encoded_length;
@@ -259,16 +242,18 @@ static size_t find_utf8_length(start, after)
     return len;
 }
 
-static void copy_into_buffer(buffer, start, after)
+static void copy_into_buffer(buffer, text, start, after)
     char *buffer;
-    Char *start, *after;
+    const Text *text;
+    long start, after;
 {
-    Char *current;
+    long current;
     size_t i = 0;
 
-    for (current = start; current != after; current = current->next) {
-        assert(current != NULL);
-        i += utf8proc_encode_char(current->value, (utf8proc_uint8_t*) &buffer[i]);
+    for (current = start; current != after; current++) {
+        assert(current < text->count);
+        i += utf8proc_encode_char(TEXT_VALUE(text, current),
+                                  (utf8proc_uint8_t*) &buffer[i]);
     }
 
     /* Null-terminate the buffer. */
@@ -277,15 +262,16 @@ static void copy_into_buffer(buffer, start, after)
 /**********************************************************************/
 
 
-static void append_word(wordlist, start, end)
-    Char *start, *end;
+static void append_word(wordlist, text, start, end)
     Wordlist *wordlist;
+    const Text *text;
+    long start, end;
 {
     Word *word;
-    Char *after = end->next;
-    size_t len = find_utf8_length(start, after);
+    long after = end + 1;
+    size_t len = find_utf8_length(text, start, after);
     char *buffer = malloc(len + 1);
-    copy_into_buffer(buffer, start, after);
+    copy_into_buffer(buffer, text, start, after);
 
     word = NEW(Word);
     /* Convert the null-terminated string to NFC. */
@@ -298,9 +284,7 @@ static void append_word(wordlist, start, end)
 static Boolean is_word_start(value)
     Charvalue value;
 {
-    const utf8proc_property_t * props = utf8proc_get_property(value);
-
-    switch (props->category) {
+    switch (UNICODE_CATEGORY(value)) {
         case UTF8PROC_CATEGORY_LU: /**< Letter, uppercase */
         case UTF8PROC_CATEGORY_LL: /**< Letter, lowercase */
         case UTF8PROC_CATEGORY_LT: /**< Letter, titlecase */
@@ -327,16 +311,16 @@ void find_words(wordlist, text)
     Text *text;
 {
     /* First and last characters of a segment. */
-    Char *first = text->first, *last;
+    long first = 0, last;
 
-    while ((last = find_next_boundary(first)) != NULL) {
+    while ((last = find_next_boundary(text, first)) < text->count) {
         /* Only append this segment if it starts with a "word-y" character. */
-        if (is_word_start(first->value)) {
-            append_word(wordlist, first, last);
+        if (is_word_start(TEXT_VALUE(text, first))) {
+            append_word(wordlist, text, first, last);
         }
 
         /* Advance to the next segment. */
-        first = last->next;
+        first = last + 1;
     }
 }
 /**********************************************************************/
@@ -345,5 +329,5 @@ void free_word(word)
     Word *word;
 {
     free(word->string);
-    free(word);
+    DISPOSE(word, Word);
 }
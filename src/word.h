@@ -27,6 +27,7 @@
 #ifndef _WORD_
 #define _WORD_
 
+#include "list.h"
 #include "text.h"
 
 #define MAX_WORDLENGTH  50
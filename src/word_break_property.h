@@ -28,6 +28,7 @@ typedef struct {
     wb_property value;
 } wb_range;
 
+#ifdef WORD_BREAK_RANGES
 static const wb_range WORD_BREAK_PROPERTY[] = {
     {0x000A, 0x000A, LF},
     {0x000B, 0x000C, Newline},
@@ -1123,3 +1124,4 @@ static const wb_range WORD_BREAK_PROPERTY[] = {
     {0x0E0020, 0x0E007F, Format},
     {0x0E0100, 0x0E01EF, Extend}
 };
+#endif
@@ -22,16 +22,22 @@
  *
  **********************************************************************/
 
+#include "match.h"
 #include "stopword.h"
 #include "wacrpt.h"
 
-#define usage  "[-S stopwordfile] correctfile generatedfile [wordacc_report]"
+#define usage  "[-k maxerrors] [-S stopwordfile] [-x maxcost] correctfile generatedfile [wordacc_report]\n" \
+"Exits with status 2, after a short report, if -k maxerrors is exceeded"
 
-char *stopwordfilename;
+#define EXCEEDED_STATUS  2
+
+char *maxerrorstring, *stopwordfilename, *maxcoststring;
 
 Option option[] =
 {
+    'k', &maxerrorstring, NULL,
     'S', &stopwordfilename, NULL,
+    'x', &maxcoststring, NULL,
     '\0'
 };
 
@@ -42,6 +48,7 @@ Wordlist wordlist[2];
 
 BEGIN_ENTRY(Id)
     Boolean found[2];
+    Charvalue number;   /* distinct for each word, and never zero */
 END_ENTRY(Id);
 
 BEGIN_TABLE_OF(Id, Idlist)
@@ -55,35 +62,52 @@ struct
     Boolean recognized;
 } Symbol;
 
-Symbol *symbol[2], **a, **b;
-
-long m, n, min_k, max_k;
+Symbol *symbol[2];
 
 typedef unsigned short F;
 #define MAX_F  65535
 
 BEGIN_ITEM(Path)
     long p;
+    long min_k, max_k;	/* the diagonals computed lie between these */
     F *f;
 END_ITEM(Path);
 
 BEGIN_LIST_OF(Path)
 END_LIST(Pathlist);
-Pathlist pathlist;
+
+typedef
+struct
+{
+    Symbol **a, **b;	/* the words of each text found in the other */
+    Charvalue *a_number, *b_number;
+			/* numbers of the Ids of "a" and "b", compared many
+			   at a time by "match_length" */
+    long m, n, min_k, max_k;
+    Pathlist pathlist;
+} Alignment;		/* the state of aligning the words of the texts,
+			   kept together so that it is passed to each step */
+
+Alignment alignment;
 
 Wacdata wacdata;
 
 /**********************************************************************/
 
-Symbol **setup_array(index, length)
+Symbol **setup_array(index, length, number)
 long index, *length;
+Charvalue **number;
 {
     Symbol **array;
     long i, j = 0;
     array = NEW_ARRAY(wordlist[index].count + 1, Symbol *);
+    *number = NEW_ARRAY(wordlist[index].count + 1, Charvalue);
     for (i = 0; i < wordlist[index].count; i++)
 	if (symbol[index][i].id->found[1 - index])
+	{
+	    (*number)[j] = symbol[index][i].id->number;
 	    array[j++] = &symbol[index][i];
+	}
     *length = j;
     return(array);
 }
@@ -95,6 +119,7 @@ char *filename[];
     long i, j;
     Word *word;
     Id *id;
+    Charvalue count = 0;
     for (i = 0; i < 2; i++)
     {
 	read_text(&text[i], filename[i], &textopt);
@@ -110,16 +135,17 @@ char *filename[];
 	    {
 		id = NEW(Id);
 		id->key = (char *) word->string;
+		id->number = ++count;
 		table_insert(&idtable, id);
 	    }
 	    id->found[i] = True;
 	    symbol[i][j++].id = id;
 	}
     }
-    a = setup_array(0, &m);
-    if (m > MAX_F)
+    alignment.a = setup_array(0, &alignment.m, &alignment.a_number);
+    if (alignment.m > MAX_F)
 	error("text stream is too long");
-    b = setup_array(1, &n);
+    alignment.b = setup_array(1, &alignment.n, &alignment.b_number);
 }
 /**********************************************************************/
 
@@ -149,65 +175,181 @@ Path *prev_path;
 }
 /**********************************************************************/
 
-void compute_f(k, path)
+void compute_f(alignment, k, path)
+Alignment *alignment;
 long k;
 Path *path;
 {
-    long i, j, value;
+    long m = alignment->m, n = alignment->n, i, j, value;
     i = initial_f(k, path->prev, &value);
     j = i + k;
-    while (i < m && j < n && a[i]->id == b[j]->id)
+    if (i < m && j < n)
     {
-	i++;
-	j++;
+	i += match_length((short) sizeof(Charvalue), &alignment->a_number[i],
+	&alignment->b_number[j], min(m - i, n - j), (Charvalue) 0);
+	j = i + k;
     }
     if (i == m)
-	min_k = k + 1;
+	alignment->min_k = k + 1;
     if (j == n)
-	max_k = k - 1;
+	alignment->max_k = k - 1;
     path->f[(k + path->p) >> 1] = i;
 }
 /**********************************************************************/
 
-void compute_pathlist()
+/* Returns False if more than "max_p" insertions and deletions are needed,
+ * unless "max_p" is negative. */
+Boolean compute_pathlist(alignment, max_p)
+Alignment *alignment;
+long max_p;
 {
     long p = -1, k;
     Path *path;
-    min_k = -m;
-    max_k = n;
-    while (min_k <= n - m)
+    alignment->min_k = -alignment->m;
+    alignment->max_k = alignment->n;
+    while (alignment->min_k <= alignment->n - alignment->m)
     {
+	if (max_p >= 0 && p == max_p)
+	    return(False);
 	path = NEW(Path);
 	path->p = ++p;
 	path->f = NEW_ARRAY(p + 1, F);
-	list_insert_last(&pathlist, path);
+	list_insert_last(&alignment->pathlist, path);
+	path->min_k = alignment->min_k;
 	k = -p;
 	while (k <= p)
 	{
-	    if (k >= min_k && k <= max_k)
-		compute_f(k, path);
+	    if (k >= alignment->min_k && k <= alignment->max_k)
+		compute_f(alignment, k, path);
 	    k += 2;
 	}
+	path->max_k = alignment->max_k;
     }
+    return(True);
 }
 /**********************************************************************/
 
-void obtain_matches()
+/* Marks the words of the matches of the paths up to "path", tracing back
+ * from its diagonal k. */
+void obtain_matches(alignment, path, k)
+Alignment *alignment;
+Path *path;
+long k;
 {
-    long k, f, start, prev_k;
-    Path *path;
-    k = n - m;
-    for (path = pathlist.last; path; path = path->prev)
+    long f, start, prev_k;
+    for ( ; path; path = path->prev)
     {
 	f = path->f[(k + path->p) >> 1];
 	start = initial_f(k, path->prev, &prev_k);
 	while (f > start)
-	    a[--f]->recognized = True;
+	    alignment->a[--f]->recognized = True;
 	k = prev_k;
     }
 }
 /**********************************************************************/
 
+void dispose_pathlist(alignment)
+Alignment *alignment;
+{
+    Path *path;
+    while ((path = alignment->pathlist.first))
+    {
+	list_remove(&alignment->pathlist, path);
+	DISPOSE_ARRAY(path->f);
+	DISPOSE(path, Path);
+    }
+}
+/**********************************************************************/
+
+/* Returns a lower bound on the insertions and deletions needed to align
+ * the words: no word is matched more often than it occurs in each text. */
+long count_edits(alignment)
+Alignment *alignment;
+{
+    long *occurs[2], count[2], i, number = 0, matchable = 0;
+    Charvalue *word[2];
+    short j;
+    word[0] = alignment->a_number;
+    word[1] = alignment->b_number;
+    count[0] = alignment->m;
+    count[1] = alignment->n;
+    for (j = 0; j < 2; j++)
+	for (i = 0; i < count[j]; i++)
+	    number = max(number, (long) word[j][i]);
+    for (j = 0; j < 2; j++)
+    {
+	occurs[j] = NEW_ARRAY(number + 1, long);
+	for (i = 0; i < count[j]; i++)
+	    occurs[j][word[j][i]]++;
+    }
+    for (i = 1; i <= number; i++)
+	matchable += min(occurs[0][i], occurs[1][i]);
+    DISPOSE_ARRAY(occurs[1]);
+    DISPOSE_ARRAY(occurs[0]);
+    return(alignment->m + alignment->n - 2 * matchable);
+}
+/**********************************************************************/
+
+/* Aligns the words in rounds of at most "max_cost" insertions and
+ * deletions, as "fastukk_sync" does with "fastukk_max_cost": a round that
+ * cannot reach the end of the texts commits to the alignment of the
+ * furthest point of its paths, and the next round starts there.
+ * Returns a bound on the number of words misrecognized beyond those of an
+ * optimal alignment. */
+long approximate_matches(alignment, max_cost)
+Alignment *alignment;
+long max_cost;
+{
+    Alignment round;
+    Path *path, *best_path;
+    long lower, rounds = 0, matched = 0, progress, best, best_k, k, i;
+    Boolean complete;
+    round = *alignment;
+    lower = count_edits(alignment);
+    do
+    {
+	list_initialize(&round.pathlist);
+	complete = compute_pathlist(&round, max_cost);
+	rounds++;
+	best_path = round.pathlist.last;
+	best_k = round.n - round.m;
+	if (!complete)
+	{
+	    /* The end is more edits away than the last path has. */
+	    if (rounds == 1)
+		lower = max(lower, max_cost + 1);
+	    best = -1;
+	    for (path = round.pathlist.first; path; path = path->next)
+		for (k = -path->p; k <= path->p; k += 2)
+		    if (k >= path->min_k && k <= path->max_k &&
+		    (progress = 2 * path->f[(k + path->p) >> 1] + k) > best)
+		    {
+			best = progress;
+			best_path = path;
+			best_k = k;
+		    }
+	}
+	obtain_matches(&round, best_path, best_k);
+	i = best_path->f[(best_k + best_path->p) >> 1];
+	dispose_pathlist(&round);
+	round.a += i;
+	round.a_number += i;
+	round.m -= i;
+	round.b += i + best_k;
+	round.b_number += i + best_k;
+	round.n -= i + best_k;
+    }
+    while (!complete);
+    if (rounds == 1)
+	return(0);
+    for (i = 0; i < alignment->m; i++)
+	if (alignment->a[i]->recognized)
+	    matched++;
+    /* Each misrecognized word is an edit of "a" and usually one of "b". */
+    return((alignment->m + alignment->n - 2 * matched - lower) / 2);
+}
+/**********************************************************************/
+
 void process_terms(termtable, length, occurs)
 Termtable *termtable;
 Wac length[], occurs[];
@@ -265,13 +407,45 @@ main(argc, argv)
 int argc;
 char *argv[];
 {
+    long maxerrors, maxcost, max_p = -1;
+    Boolean exceeded = False;
     initialize(&argc, argv, usage, option);
     if (argc < 2 || argc > 3)
 	error("invalid number of files");
+    maxerrors = option_value(maxerrorstring, -1L, 0L, LONG_MAX,
+    "invalid maximum number of errors");
+    maxcost = option_value(maxcoststring, -1L, 1L, LONG_MAX,
+    "invalid maximum cost");
+    if (maxerrors >= 0 && maxcost >= 0)
+	error("-k and -x may not both be specified");
     init_stopwords(stopwordfilename);
     setup(argv);
-    compute_pathlist();
-    obtain_matches();
+    /* The words of "a" and "b" that are left unmatched are the edits, so
+     * there are more than "maxerrors" misrecognized words when there are
+     * more than this many. */
+    if (maxerrors >= 0)
+    {
+	max_p = 2 * (maxerrors - wordlist[0].count) + alignment.m +
+	alignment.n;
+	exceeded = (max_p < 0);
+    }
+    if (maxcost >= 0)
+	fprintf(stderr, "%s: approximate alignment: at most %ld misrecognized "
+	"words more than optimal\n", exec_name,
+	approximate_matches(&alignment, maxcost));
+    else if (exceeded || !compute_pathlist(&alignment, max_p))
+	exceeded = True;
+    else
+	obtain_matches(&alignment, alignment.pathlist.last,
+	alignment.n - alignment.m);
+    if (exceeded)
+    {
+	/* The short report cannot be read by wordaccsum, so a batch must not
+	 * take it for a finished one. */
+	write_exceeded_wacrpt(wordlist[0].count, maxerrors,
+	(argc == 3 ? argv[2] : NULL));
+	terminate_status(EXCEEDED_STATUS);
+    }
     determine_wacdata();
     write_wacrpt(&wacdata, (argc == 3 ? argv[2] : NULL));
     terminate();
@@ -22,6 +22,7 @@
  *
  **********************************************************************/
 
+#include "output.h"
 #include "sort.h"
 #include "wacrpt.h"
 
@@ -36,16 +37,24 @@ Termtable termtable;
 
 /**********************************************************************/
 
+/* The text and words of each file are taken from an arena of their own,
+ * and released at once; the terms outlive them, so they are taken from
+ * the heap. */
 void process_file(filename)
 char *filename;
 {
+    Arena *arena, *previous;
     Word *word;
+    arena = new_arena();
+    previous = use_arena(arena);
     read_text(&text, filename, &textopt);
     find_words(&wordlist, &text);
+    use_arena(previous);
     for (word = wordlist.first; word; word = word->next)
 	add_term(&termtable, word->string, 1, 0);
-    list_empty(&text, free);
+    text_initialize(&text);
     list_empty(&wordlist, free_word);
+    free_arena(arena);
 }
 /**********************************************************************/
 
@@ -65,28 +74,35 @@ Term *term1, *term2;
 }
 /**********************************************************************/
 
-void write_array()
+void write_array(output)
+Output *output;
 {
     long i, total = 0;
-    printf("   Count\n");
+    output_string(output, "   Count\n");
     for (i = 0; i < termtable.count; i++)
     {
-	printf("%8ld   %s\n", termtable.array[i]->wac.count,
-	termtable.array[i]->key);
+	output_long(output, termtable.array[i]->wac.count, 8);
+	output_string(output, "   ");
+	output_string(output, termtable.array[i]->key);
+	OUTPUT_BYTE(output, '\n');
 	total += termtable.array[i]->wac.count;
     }
-    printf("%8ld   Total\n", total);
+    output_long(output, total, 8);
+    output_string(output, "   Total\n");
 }
 /**********************************************************************/
 
 void write_report()
 {
+    Output output;
+    open_output(&output, NULL);
     table_in_array(&termtable);
     sort(termtable.count, termtable.array, order_by_key);
-    write_array();
-    printf("\n\n");
+    write_array(&output);
+    output_string(&output, "\n\n");
     sort(termtable.count, termtable.array, order_by_count);
-    write_array();
+    write_array(&output);
+    close_output(&output);
 }
 /**********************************************************************/
 
@@ -0,0 +1,100 @@
+#include "greatest.h"
+
+#include <pthread.h>
+#include <util.h>
+
+typedef struct {
+    long a, b, c;
+} Node;
+
+TEST arena_allocates_zeroed_memory() {
+    Arena *arena = new_arena(), *previous;
+    Node *node;
+    char *array;
+    long i;
+
+    previous = use_arena(arena);
+    node = NEW(Node);
+    array = NEW_ARRAY(1000000, char);
+    use_arena(previous);
+
+    ASSERT_EQ(0L, node->a + node->b + node->c);
+    for (i = 0; i < 1000000; i++)
+        ASSERT_EQ(0, array[i]);
+    free_arena(arena);
+    PASS();
+}
+
+TEST arena_reuses_disposed_nodes() {
+    Arena *arena = new_arena(), *previous;
+    Node *node, *other;
+
+    previous = use_arena(arena);
+    node = NEW(Node);
+    node->a = 42;
+    DISPOSE(node, Node);
+    other = NEW(Node);
+    use_arena(previous);
+
+    ASSERT_EQ(node, other);
+    ASSERT_EQ(0L, other->a);
+    free_arena(arena);
+    PASS();
+}
+
+TEST arena_leaves_heap_memory_to_the_heap() {
+    Arena *arena = new_arena(), *previous;
+    Node *node = NEW(Node);
+
+    previous = use_arena(arena);
+    ASSERT_EQ(NULL, previous);
+    DISPOSE(node, Node);
+    node = NEW(Node);
+    use_arena(previous);
+
+    free_arena(arena);
+    node = NEW(Node);
+    DISPOSE(node, Node);
+    PASS();
+}
+
+static void *dispose_node(void *node) {
+    DISPOSE(node, Node);
+    return NULL;
+}
+
+TEST arena_keeps_nodes_disposed_by_other_threads() {
+    Arena *arena = new_arena(), *previous;
+    Node *node, *other;
+    pthread_t thread;
+
+    previous = use_arena(arena);
+    node = NEW(Node);
+    /* The free list belongs to this thread while the arena is current. */
+    pthread_create(&thread, NULL, dispose_node, node);
+    pthread_join(thread, NULL);
+    other = NEW(Node);
+    use_arena(previous);
+
+    ASSERT(node != other);
+    free_arena(arena);
+    PASS();
+}
+
+TEST arena_is_released_when_current() {
+    Arena *arena = new_arena();
+
+    use_arena(arena);
+    NEW_ARRAY(100, Node);
+    free_arena(arena);
+    ASSERT_EQ(NULL, use_arena(NULL));
+    PASS();
+}
+
+SUITE(arena_suite) {
+    RUN_TEST(arena_allocates_zeroed_memory);
+    RUN_TEST(arena_reuses_disposed_nodes);
+    RUN_TEST(arena_leaves_heap_memory_to_the_heap);
+    RUN_TEST(arena_keeps_nodes_disposed_by_other_threads);
+    RUN_TEST(arena_is_released_when_current);
+}
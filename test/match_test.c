@@ -0,0 +1,64 @@
+#include "greatest.h"
+
+#include <stdint.h>
+#include <match.h>
+
+#define MATCH_LENGTH 100
+
+static uint8_t narrow[2][MATCH_LENGTH];
+static uint16_t wide[2][MATCH_LENGTH];
+static Charvalue widest[2][MATCH_LENGTH];
+
+/* Fills both arrays of each width with "length" equal values, and sets
+ * position "at" of the second to "value". */
+static void fill(long length, long at, Charvalue value) {
+    long i;
+
+    for (i = 0; i < length; i++) {
+        narrow[0][i] = narrow[1][i] = 'a' + i % 26;
+        wide[0][i] = wide[1][i] = 0x3B1 + i % 25;
+        widest[0][i] = widest[1][i] = 0x1D400 + i % 52;
+    }
+    if (at < length) {
+        narrow[1][at] = (uint8_t) value;
+        wide[1][at] = (uint16_t) value;
+        widest[1][at] = value;
+    }
+}
+
+TEST match_length_stops_at_first_difference() {
+    long length, at;
+
+    for (length = 0; length <= MATCH_LENGTH; length += 7)
+        for (at = 0; at <= length; at++) {
+            fill(length, at, '0');
+            ASSERT_EQ(at, match_length(1, narrow[0], narrow[1], length,
+                                       REJECT_CHARACTER));
+            ASSERT_EQ(at, match_length(2, wide[0], wide[1], length,
+                                       REJECT_CHARACTER));
+            ASSERT_EQ(at, match_length(4, widest[0], widest[1], length,
+                                       REJECT_CHARACTER));
+        }
+    PASS();
+}
+
+TEST match_length_stops_at_equal_reject_characters() {
+    long at;
+
+    for (at = 0; at < MATCH_LENGTH; at++) {
+        fill(MATCH_LENGTH, at, REJECT_CHARACTER);
+        narrow[0][at] = wide[0][at] = widest[0][at] = REJECT_CHARACTER;
+        ASSERT_EQ(at, match_length(1, narrow[0], narrow[1], MATCH_LENGTH,
+                                   REJECT_CHARACTER));
+        ASSERT_EQ(at, match_length(2, wide[0], wide[1], MATCH_LENGTH,
+                                   REJECT_CHARACTER));
+        ASSERT_EQ(at, match_length(4, widest[0], widest[1], MATCH_LENGTH,
+                                   REJECT_CHARACTER));
+    }
+    PASS();
+}
+
+SUITE(match_suite) {
+    RUN_TEST(match_length_stops_at_first_difference);
+    RUN_TEST(match_length_stops_at_equal_reject_characters);
+}
@@ -0,0 +1,84 @@
+#include "greatest.h"
+
+#include <output.h>
+
+#define OUTPUT_TEST_FILE  "output_test.txt"
+
+static Output output_;
+static Output *output = &output_;
+static char contents[256];
+
+static void open_test_output(void *unused) {
+    open_output(output, OUTPUT_TEST_FILE);
+}
+
+/* Closes the output and reads back what was written. */
+static char *output_contents() {
+    FILE *f;
+    size_t length;
+
+    close_output(output);
+    f = fopen(OUTPUT_TEST_FILE, "r");
+    length = fread(contents, 1, sizeof(contents) - 1, f);
+    fclose(f);
+    remove(OUTPUT_TEST_FILE);
+    contents[length] = '\0';
+    return contents;
+}
+
+TEST output_long_pads_like_printf() {
+    output_long(output, 42L, 8);
+    output_long(output, -7L, 3);
+    output_long(output, 123456789L, 8);
+    output_long(output, 0L, 0);
+    ASSERT_STR_EQ("      42 -71234567890", output_contents());
+    PASS();
+}
+
+TEST output_padded_pads_on_the_right() {
+    output_padded(output, "ab", 4);
+    output_padded(output, "abcdef", 4);
+    OUTPUT_BYTE(output, '|');
+    ASSERT_STR_EQ("ab  abcdef|", output_contents());
+    PASS();
+}
+
+TEST output_char_matches_char_to_string() {
+    output_char(output, False, 'a', False);
+    output_char(output, True, 'b', False);
+    output_char(output, False, 0x07, False);
+    output_char(output, False, NEWLINE, True);
+    output_char(output, False, 0xE0080, False);
+    output_char(output, False, 0x50cd, False);
+    ASSERT_STR_EQ("a^b<07><\\n><E0080>働", output_contents());
+    PASS();
+}
+
+TEST output_bytes_spans_flushes() {
+    FILE *f;
+    long i;
+    char tail[4];
+
+    for (i = 0; i < OUTPUT_BUFFER_SIZE; i++)
+        OUTPUT_BYTE(output, 'x');
+    output_string(output, "yz");
+    close_output(output);
+    f = fopen(OUTPUT_TEST_FILE, "r");
+    fseek(f, 0L, SEEK_END);
+    ASSERT_EQ_FMT((long) OUTPUT_BUFFER_SIZE + 2, ftell(f), "%ld");
+    fseek(f, -3L, SEEK_END);
+    tail[fread(tail, 1, 3, f)] = '\0';
+    fclose(f);
+    remove(OUTPUT_TEST_FILE);
+    ASSERT_STR_EQ("xyz", tail);
+    PASS();
+}
+
+SUITE(output_suite) {
+    SET_SETUP(open_test_output, NULL);
+
+    RUN_TEST(output_long_pads_like_printf);
+    RUN_TEST(output_padded_pads_on_the_right);
+    RUN_TEST(output_char_matches_char_to_string);
+    RUN_TEST(output_bytes_spans_flushes);
+}
@@ -1,4 +1,11 @@
+#include "arena_test.c"
+#include "match_test.c"
+#include "output_test.c"
+#include "suffix_test.c"
+#include "sync_test.c"
 #include "text_test.c"
+#include "unicode_test.c"
+#include "utf8_test.c"
 #include "word_test.c"
 
 #include "greatest.h"
@@ -8,8 +15,15 @@ GREATEST_MAIN_DEFS();
 int main(int argc, char **argv) {
     GREATEST_MAIN_BEGIN();
 
+    RUN_SUITE(arena_suite);
+    RUN_SUITE(match_suite);
+    RUN_SUITE(output_suite);
+    RUN_SUITE(suffix_suite);
+    RUN_SUITE(sync_suite);
     RUN_SUITE(cstring_to_text_suite);
     RUN_SUITE(char_to_string_suite);
+    RUN_SUITE(decode_utf8_suite);
+    RUN_SUITE(unicode_property_suite);
 
     RUN_SUITE(find_words_suite);
 
@@ -0,0 +1,72 @@
+#include "greatest.h"
+#include "test_utils.h"
+
+#include <suffix.h>
+
+static Text strings[2];
+
+/* Finds a longest common substring by comparing every pair of starting
+ * positions, in the order in which longest_match in sync.c does. */
+static long brute_force(long maxlen, long start1, long stop1, long start2,
+                        long stop2, long *mstart1, long *mstart2) {
+    long s1, s2, length;
+    Charvalue value;
+
+    for (s1 = start1; s1 <= stop1; s1++)
+        for (s2 = start2; s2 <= stop2; s2++) {
+            for (length = 0; s1 + length <= stop1 && s2 + length <= stop2;
+                 length++) {
+                value = TEXT_VALUE(&strings[0], s1 + length);
+                if (value != TEXT_VALUE(&strings[1], s2 + length) ||
+                    value == REJECT_CHARACTER)
+                    break;
+            }
+            if (length > maxlen) {
+                maxlen = length;
+                *mstart1 = s1;
+                *mstart2 = s2;
+            }
+        }
+    return maxlen;
+}
+
+TEST longest_common_substring_matches_brute_force() {
+    unsigned long seed = 1;
+    long trial, i, k, maxlen, start[2], stop[2], expected[2], found[2];
+    long expected_length, found_length;
+    int alphabet;
+
+    for (trial = 0; trial < 2000; trial++) {
+        seed = seed * 1103515245 + 12345;
+        alphabet = 1 + (seed >> 16) % 5;
+        for (k = 0; k < 2; k++) {
+            text_empty(&strings[k]);
+            for (i = 0; i < 40; i++) {
+                seed = seed * 1103515245 + 12345;
+                append_char(&strings[k], False, (seed >> 16) % 13 == 0 ?
+                            REJECT_CHARACTER :
+                            'a' + (Charvalue) ((seed >> 20) % alphabet));
+            }
+            start[k] = (long) ((seed >> 8) % 20);
+            stop[k] = start[k] + (long) ((seed >> 12) % 21) - 1;
+        }
+        maxlen = (long) (trial % 3);
+        expected[0] = expected[1] = found[0] = found[1] = -1;
+        expected_length = brute_force(maxlen, start[0], stop[0], start[1],
+                                      stop[1], &expected[0], &expected[1]);
+        found_length = longest_common_substring(maxlen, &strings[0], start[0],
+                                                stop[0], &strings[1], start[1],
+                                                stop[1], &found[0], &found[1]);
+        ASSERT_EQ(expected_length, found_length);
+        ASSERT_EQ(expected[0], found[0]);
+        ASSERT_EQ(expected[1], found[1]);
+    }
+    PASS();
+}
+
+SUITE(suffix_suite) {
+    SET_SETUP(initialize_texts, (Text*[]) {&strings[0], &strings[1], NULL});
+    SET_TEARDOWN(deinitialize_texts, (Text*[]) {&strings[0], &strings[1], NULL});
+
+    RUN_TEST(longest_common_substring_matches_brute_force);
+}
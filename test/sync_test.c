@@ -0,0 +1,700 @@
+#include "greatest.h"
+#include "test_utils.h"
+
+#include <pthread.h>
+#include <sync.h>
+
+static Text pair[2];
+
+/* Builds in "texts" a text from "length" characters of a small alphabet,
+ * and a copy of it with about "rate" percent of the characters edited. */
+static void make_texts(Text *texts, unsigned long seed, long length, int rate,
+                       Charvalue base) {
+    long i;
+    Charvalue value;
+
+    text_empty(&texts[0]);
+    text_empty(&texts[1]);
+    for (i = 0; i < length; i++) {
+        seed = seed * 1103515245 + 12345;
+        value = (seed >> 16) % 40 == 0 ? REJECT_CHARACTER : base + (seed >> 16) % 7;
+        append_char(&texts[0], False, value);
+        seed = seed * 1103515245 + 12345;
+        if ((long) ((seed >> 16) % 100) < rate) {
+            switch ((seed >> 8) % 3) {
+            case 0:
+                continue;
+            case 1:
+                append_char(&texts[1], False, base + (seed >> 20) % 7);
+                continue;
+            default:
+                append_char(&texts[1], False, base + (seed >> 20) % 7);
+            }
+        }
+        append_char(&texts[1], False, value);
+    }
+}
+
+static void make_pair(unsigned long seed, long length, int rate, Charvalue base) {
+    make_texts(pair, seed, length, rate, base);
+}
+
+/* Describes the synclist in "buffer" and disposes of it. */
+static void describe(Synclist *synclist, char *buffer) {
+    Sync *sync;
+
+    buffer[0] = '\0';
+    while ((sync = synclist->first)) {
+        sprintf(buffer + strlen(buffer), "%c%ld+%ld/%ld+%ld ",
+                sync->match ? 'M' : 'U',
+                sync->substr[0].start, sync->substr[0].length,
+                sync->substr[1].start, sync->substr[1].length);
+        list_remove(synclist, sync);
+    }
+}
+
+static char diagonal[100000], other[100000];
+
+TEST bit_parallel_sync_matches_diagonal() {
+    Synclist synclist;
+    unsigned long seed;
+    static const Charvalue base[] = { 'a', 0x3B1, 0x1D400 };
+
+    for (seed = 1; seed <= 300; seed++) {
+        make_pair(seed, (long) (seed % 7) * 53, (int) (seed % 60),
+                  base[seed % 3]);
+        fastukk_method = SYNC_DIAGONAL;
+        fastukk_sync(&synclist, pair);
+        describe(&synclist, diagonal);
+        fastukk_method = SYNC_BIT_PARALLEL;
+        fastukk_sync(&synclist, pair);
+        describe(&synclist, other);
+        ASSERT_STR_EQ(diagonal, other);
+    }
+    fastukk_method = SYNC_AUTOMATIC;
+    PASS();
+}
+
+TEST linear_space_sync_matches_diagonal() {
+    Synclist synclist;
+    unsigned long seed;
+
+    for (seed = 1; seed <= 100; seed++) {
+        make_pair(seed, (long) (seed % 5) * 97, (int) (seed % 40), 'a');
+        fastukk_method = SYNC_DIAGONAL;
+        fastukk_sync(&synclist, pair);
+        describe(&synclist, diagonal);
+        fastukk_method = SYNC_LINEAR_SPACE;
+        fastukk_sync(&synclist, pair);
+        describe(&synclist, other);
+        ASSERT_STR_EQ(diagonal, other);
+    }
+    fastukk_method = SYNC_AUTOMATIC;
+    PASS();
+}
+
+TEST automatic_sync_matches_diagonal_for_distant_texts() {
+    Synclist synclist;
+
+    make_pair(7, 2000, 50, 'a');
+    fastukk_method = SYNC_DIAGONAL;
+    fastukk_sync(&synclist, pair);
+    describe(&synclist, diagonal);
+    fastukk_method = SYNC_AUTOMATIC;
+    fastukk_sync(&synclist, pair);
+    describe(&synclist, other);
+    ASSERT_STR_EQ(diagonal, other);
+    PASS();
+}
+
+TEST threaded_sync_matches_diagonal() {
+    Synclist synclist;
+
+    make_pair(11, 8000, 60, 'a');
+    fastukk_method = SYNC_DIAGONAL;
+    fastukk_sync(&synclist, pair);
+    describe(&synclist, diagonal);
+    fastukk_threads = 3;
+    fastukk_sync(&synclist, pair);
+    describe(&synclist, other);
+    fastukk_threads = 1;
+    fastukk_method = SYNC_AUTOMATIC;
+    ASSERT_STR_EQ(diagonal, other);
+    PASS();
+}
+
+/* Returns the number of edits of the alignment in "synclist". */
+static long edits(Synclist *synclist) {
+    Sync *sync;
+    long count = 0;
+
+    for (sync = synclist->first; sync; sync = sync->next)
+        if (!sync->match)
+            count += max(sync->substr[0].length, sync->substr[1].length);
+    return count;
+}
+
+TEST threaded_context_keeps_its_workers() {
+    Synccontext context;
+    Synclist synclist;
+    short threads[] = { 3, 1, 2 };
+    int i;
+
+    make_pair(13, 8000, 60, 'a');
+    fastukk_method = SYNC_DIAGONAL;
+    fastukk_sync(&synclist, pair);
+    describe(&synclist, diagonal);
+    fastukk_method = SYNC_AUTOMATIC;
+    initialize_synccontext(&context);
+    context.method = SYNC_DIAGONAL;
+    /* The workers started for the first alignment wait for later ones,
+     * which may use fewer of them. */
+    for (i = 0; i < 3; i++) {
+        context.threads = threads[i];
+        context_sync(&context, &synclist, pair);
+        describe(&synclist, other);
+        ASSERT_STR_EQ(diagonal, other);
+    }
+    free_synccontext(&context);
+    PASS();
+}
+
+TEST anchored_sync_is_optimal_for_similar_texts() {
+    Synclist synclist;
+    long count;
+
+    make_pair(5, 3000, 2, 'a');
+    fastukk_method = SYNC_DIAGONAL;
+    fastukk_sync(&synclist, pair);
+    count = edits(&synclist);
+    describe(&synclist, diagonal);
+    fastukk_method = SYNC_ANCHORED;
+    fastukk_sync(&synclist, pair);
+    fastukk_method = SYNC_AUTOMATIC;
+    ASSERT_EQ(count, edits(&synclist));
+    ASSERT(fastukk_anchor_coverage > 2500);
+    describe(&synclist, other);
+    PASS();
+}
+
+TEST anchored_sync_covers_equal_texts() {
+    Synclist synclist;
+    long i, count = 0;
+
+    /* Only the reject characters are unmatched, and the anchors cover
+     * nearly everything else. */
+    make_pair(9, 500, 0, 'a');
+    for (i = 0; i < pair[0].count; i++)
+        if (TEXT_VALUE(&pair[0], i) == REJECT_CHARACTER)
+            count++;
+    fastukk_method = SYNC_ANCHORED;
+    fastukk_sync(&synclist, pair);
+    fastukk_method = SYNC_AUTOMATIC;
+    ASSERT_EQ(count, edits(&synclist));
+    ASSERT(fastukk_anchor_coverage > 450);
+    describe(&synclist, other);
+    PASS();
+}
+
+/* Appends "string" to "text". */
+static void append_string(Text *text, char *string) {
+    while (*string)
+        append_char(text, False, (unsigned char) *string++);
+}
+
+TEST anchored_sync_falls_back_for_sparse_anchors() {
+    Synclist synclist;
+    Text noisy[2];
+    long i;
+
+    /* With 60% of the characters edited, the only anchor is a substring
+     * that starts one text and ends the other. */
+    text_initialize(&noisy[0]);
+    text_initialize(&noisy[1]);
+    make_texts(noisy, 31, 2000, 60, 'a');
+    text_empty(&pair[0]);
+    text_empty(&pair[1]);
+    append_string(&pair[0], "ABCDEFGHIJKL");
+    for (i = 0; i < noisy[0].count; i++)
+        append_char(&pair[0], False, TEXT_VALUE(&noisy[0], i));
+    for (i = 0; i < noisy[1].count; i++)
+        append_char(&pair[1], False, TEXT_VALUE(&noisy[1], i));
+    append_string(&pair[1], "ABCDEFGHIJKL");
+    text_empty(&noisy[0]);
+    text_empty(&noisy[1]);
+    fastukk_method = SYNC_DIAGONAL;
+    fastukk_sync(&synclist, pair);
+    describe(&synclist, diagonal);
+    fastukk_method = SYNC_ANCHORED;
+    fastukk_sync(&synclist, pair);
+    fastukk_method = SYNC_AUTOMATIC;
+    ASSERT_EQ(0, fastukk_anchor_coverage);
+    describe(&synclist, other);
+    ASSERT_STR_EQ(diagonal, other);
+    PASS();
+}
+
+TEST line_sync_aligns_only_changed_lines() {
+    Synclist synclist;
+    long i, count, unchanged = 0;
+    char line[40];
+
+    /* Every tenth line differs by a character, and a line is inserted
+     * after every twenty-fifth. */
+    text_empty(&pair[0]);
+    text_empty(&pair[1]);
+    for (i = 0; i < 200; i++) {
+        sprintf(line, "line %ld of the text\n", i);
+        append_string(&pair[0], line);
+        if (i % 10 == 3)
+            line[1] = 'a';
+        else
+            unchanged += strlen(line);
+        append_string(&pair[1], line);
+        if (i % 25 == 7)
+            append_string(&pair[1], "an inserted line\n");
+    }
+    fastukk_method = SYNC_DIAGONAL;
+    fastukk_sync(&synclist, pair);
+    count = edits(&synclist);
+    describe(&synclist, diagonal);
+    fastukk_method = SYNC_LINES;
+    fastukk_sync(&synclist, pair);
+    ASSERT_EQ(count, edits(&synclist));
+    ASSERT_EQ(unchanged, fastukk_anchor_coverage);
+    describe(&synclist, other);
+    fastukk_threads = 3;
+    fastukk_sync(&synclist, pair);
+    describe(&synclist, diagonal);
+    fastukk_threads = 1;
+    fastukk_method = SYNC_AUTOMATIC;
+    ASSERT_STR_EQ(other, diagonal);
+    PASS();
+}
+
+TEST line_sync_handles_texts_without_common_lines() {
+    Synclist synclist;
+
+    make_pair(17, 400, 10, 'a');
+    fastukk_method = SYNC_DIAGONAL;
+    fastukk_sync(&synclist, pair);
+    describe(&synclist, diagonal);
+    fastukk_method = SYNC_LINES;
+    fastukk_sync(&synclist, pair);
+    fastukk_method = SYNC_AUTOMATIC;
+    ASSERT_EQ(0, fastukk_anchor_coverage);
+    describe(&synclist, other);
+    ASSERT_STR_EQ(diagonal, other);
+    PASS();
+}
+
+TEST approximate_sync_is_optimal_within_max_cost() {
+    Synclist synclist;
+
+    make_pair(21, 2000, 3, 'a');
+    fastukk_method = SYNC_DIAGONAL;
+    fastukk_sync(&synclist, pair);
+    describe(&synclist, diagonal);
+    fastukk_method = SYNC_AUTOMATIC;
+    fastukk_max_cost = 1000;
+    fastukk_sync(&synclist, pair);
+    fastukk_max_cost = -1;
+    ASSERT_EQ(0, fastukk_excess);
+    describe(&synclist, other);
+    ASSERT_STR_EQ(diagonal, other);
+    PASS();
+}
+
+/* Builds in "pair" a page of about "length" characters of words in lines,
+ * and a copy of it in which runs of up to 15 characters are deleted,
+ * replaced by garbage or inserted, at about "rate" percent of the
+ * characters in all, as OCR errors tend to come. */
+static void make_page(unsigned long seed, long length, int rate) {
+    static char *words[] = {
+        "the", "of", "and", "to", "in", "is", "that", "for", "with", "as",
+        "page", "report", "accuracy", "character", "evaluation", "text"
+    };
+    char *word;
+    long i, j, run, kind, column = 0;
+
+    text_empty(&pair[0]);
+    text_empty(&pair[1]);
+    while (pair[0].count < length) {
+        seed = seed * 1103515245 + 12345;
+        word = words[(seed >> 16) % 16];
+        append_string(&pair[0], word);
+        column += strlen(word) + 1;
+        append_char(&pair[0], False, column > 60 ? '\n' : ' ');
+        if (column > 60)
+            column = 0;
+    }
+    for (i = 0; i < pair[0].count; ) {
+        seed = seed * 1103515245 + 12345;
+        if ((long) ((seed >> 16) % 800) < rate) {
+            run = 1 + (seed >> 8) % 15;
+            kind = (seed >> 12) % 3;
+            for (j = 0; j < run && kind != 0; j++) {
+                seed = seed * 1103515245 + 12345;
+                append_char(&pair[1], False, 'a' + (seed >> 16) % 26);
+            }
+            if (kind != 1) {
+                i += run;
+                continue;
+            }
+        }
+        append_char(&pair[1], False, TEXT_VALUE(&pair[0], i));
+        i++;
+    }
+}
+
+TEST approximate_sync_stays_close_on_a_page() {
+    Synclist synclist;
+    long count;
+    static const int rate[] = { 5, 30 };
+    int i;
+
+    for (i = 0; i < 2; i++) {
+        make_page(29, 15000, rate[i]);
+        fastukk_sync(&synclist, pair);
+        count = edits(&synclist);
+        describe(&synclist, diagonal);
+        fastukk_max_cost = 5;
+        fastukk_sync(&synclist, pair);
+        fastukk_max_cost = -1;
+        /* Chance matches within long runs of errors are not committed to,
+         * so the alignment is nearly optimal. */
+        ASSERT(edits(&synclist) <= count + count / 20);
+        describe(&synclist, other);
+    }
+    PASS();
+}
+
+TEST approximate_sync_bounds_its_excess() {
+    Synclist synclist;
+    long count, approximate;
+
+    make_pair(23, 3000, 60, 'a');
+    fastukk_sync(&synclist, pair);
+    count = edits(&synclist);
+    describe(&synclist, diagonal);
+    fastukk_max_cost = 20;
+    fastukk_sync(&synclist, pair);
+    fastukk_max_cost = -1;
+    approximate = edits(&synclist);
+    ASSERT(approximate >= count);
+    ASSERT(approximate - fastukk_excess <= count);
+    ASSERT(fastukk_excess > 0);
+    describe(&synclist, other);
+    PASS();
+}
+
+TEST bit_parallel_sync_handles_empty_texts() {
+    Synclist synclist;
+
+    make_pair(1, 0, 0, 'a');
+    append_char(&pair[1], False, 'x');
+    fastukk_method = SYNC_BIT_PARALLEL;
+    fastukk_sync(&synclist, pair);
+    fastukk_method = SYNC_AUTOMATIC;
+    describe(&synclist, other);
+    ASSERT_STR_EQ("U0+0/0+1 ", other);
+    PASS();
+}
+
+TEST limited_sync_stops_beyond_max_edits() {
+    Synclist synclist;
+    long count;
+
+    make_pair(3, 1000, 10, 'a');
+    fastukk_method = SYNC_DIAGONAL;
+    fastukk_sync(&synclist, pair);
+    count = edits(&synclist);
+    describe(&synclist, diagonal);
+    fastukk_method = SYNC_AUTOMATIC;
+    fastukk_max_edits = count;
+    ASSERT(fastukk_sync(&synclist, pair));
+    describe(&synclist, other);
+    ASSERT_STR_EQ(diagonal, other);
+    fastukk_max_edits = count - 1;
+    ASSERT_FALSE(fastukk_sync(&synclist, pair));
+    fastukk_max_edits = -1;
+    describe(&synclist, other);
+    sprintf(diagonal, "U0+%ld/0+%ld ", pair[0].count, pair[1].count);
+    ASSERT_STR_EQ(diagonal, other);
+    PASS();
+}
+
+TEST limited_linear_space_sync_stops_beyond_max_edits() {
+    Synclist synclist;
+    long count;
+
+    make_pair(4, 500, 20, 'a');
+    fastukk_method = SYNC_LINEAR_SPACE;
+    fastukk_sync(&synclist, pair);
+    count = edits(&synclist);
+    describe(&synclist, diagonal);
+    fastukk_max_edits = count;
+    ASSERT(fastukk_sync(&synclist, pair));
+    describe(&synclist, other);
+    ASSERT_STR_EQ(diagonal, other);
+    fastukk_max_edits = count - 1;
+    ASSERT_FALSE(fastukk_sync(&synclist, pair));
+    fastukk_max_edits = -1;
+    fastukk_method = SYNC_AUTOMATIC;
+    describe(&synclist, other);
+    PASS();
+}
+
+#define NUM_JOBS  4
+
+typedef struct {
+    Text texts[2];
+    short method;
+    char description[100000];
+} Job;
+
+static Job job[NUM_JOBS];
+
+static void *run_job(void *argument) {
+    Job *job = argument;
+    Synccontext context;
+    Synclist synclist;
+    int i;
+
+    initialize_synccontext(&context);
+    context.method = job->method;
+    /* The context is reused, as its buffers are meant to be. */
+    for (i = 0; i < 3; i++) {
+        context_sync(&context, &synclist, job->texts);
+        describe(&synclist, job->description);
+    }
+    free_synccontext(&context);
+    return NULL;
+}
+
+TEST contexts_sync_concurrently() {
+    pthread_t thread[NUM_JOBS];
+    static const short method[NUM_JOBS] = {
+        SYNC_DIAGONAL, SYNC_BIT_PARALLEL, SYNC_LINEAR_SPACE, SYNC_ANCHORED
+    };
+    int i;
+
+    for (i = 0; i < NUM_JOBS; i++) {
+        text_initialize(&job[i].texts[0]);
+        text_initialize(&job[i].texts[1]);
+        make_texts(job[i].texts, 20 + i, 1500, 5 + 10 * i, 'a');
+        job[i].method = method[i];
+        ASSERT_EQ(0, pthread_create(&thread[i], NULL, run_job, &job[i]));
+    }
+    for (i = 0; i < NUM_JOBS; i++)
+        pthread_join(thread[i], NULL);
+    for (i = 0; i < NUM_JOBS; i++) {
+        Synclist synclist;
+
+        fastukk_method = method[i];
+        fastukk_sync(&synclist, job[i].texts);
+        describe(&synclist, diagonal);
+        ASSERT_STR_EQ(diagonal, job[i].description);
+        text_empty(&job[i].texts[0]);
+        text_empty(&job[i].texts[1]);
+    }
+    fastukk_method = SYNC_AUTOMATIC;
+    PASS();
+}
+
+TEST anchored_sync_divides_gaps_among_threads() {
+    Synclist synclist;
+
+    make_pair(13, 6000, 15, 'a');
+    fastukk_method = SYNC_ANCHORED;
+    fastukk_sync(&synclist, pair);
+    describe(&synclist, diagonal);
+    fastukk_threads = 4;
+    fastukk_sync(&synclist, pair);
+    describe(&synclist, other);
+    fastukk_threads = 1;
+    fastukk_method = SYNC_AUTOMATIC;
+    ASSERT_STR_EQ(diagonal, other);
+    PASS();
+}
+
+/* Describes the synclist of "num_text" texts in "buffer" and disposes of
+ * it. */
+static void describe_streams(Synclist *synclist, short num_text,
+                             char *buffer) {
+    Sync *sync;
+    short i;
+
+    buffer[0] = '\0';
+    while ((sync = synclist->first)) {
+        sprintf(buffer + strlen(buffer), "%c", sync->match ? 'M' : 'U');
+        for (i = 0; i < num_text; i++)
+            sprintf(buffer + strlen(buffer), "%ld+%ld%c",
+                    sync->substr[i].start, sync->substr[i].length,
+                    i + 1 < num_text ? '/' : ' ');
+        list_remove(synclist, sync);
+    }
+}
+
+TEST synchronize_matches_ranges_on_threads() {
+    static Text texts[4];
+    Synclist synclist;
+    short i;
+
+    make_texts(texts, 27, 3000, 8, 'a');
+    make_texts(texts + 2, 27, 3000, 12, 'a');
+    synchronize(&synclist, 4, texts);
+    ASSERT(synclist.count > 100);
+    describe_streams(&synclist, 4, diagonal);
+    synchronize_threads = 4;
+    synchronize(&synclist, 4, texts);
+    synchronize_threads = 1;
+    describe_streams(&synclist, 4, other);
+    ASSERT_STR_EQ(diagonal, other);
+    for (i = 0; i < 4; i++)
+        text_empty(&texts[i]);
+    PASS();
+}
+
+/* Describes the items of "array", as "describe_streams" does, and
+ * releases it. */
+static void describe_array(Syncarray *array, char *buffer) {
+    Syncview view;
+    Sync *sync;
+    long match = 0;
+    short i;
+
+    buffer[0] = '\0';
+    for (sync = first_sync(&view, array); sync; sync = next_sync(&view)) {
+        if (sync->match && *sync->match != ++match)
+            strcat(buffer, "!");
+        sprintf(buffer + strlen(buffer), "%c", sync->match ? 'M' : 'U');
+        for (i = 0; i < array->num_text; i++)
+            sprintf(buffer + strlen(buffer), "%ld+%ld%c",
+                    sync->substr[i].start, sync->substr[i].length,
+                    i + 1 < array->num_text ? '/' : ' ');
+    }
+    free_syncarray(array);
+}
+
+TEST syncarray_iterates_as_synclist() {
+    static Text texts[4];
+    Synclist synclist;
+    Syncarray array;
+    short i;
+
+    fastukk_method = SYNC_AUTOMATIC;
+    make_pair(31, 2000, 10, 'a');
+    fastukk_sync(&synclist, pair);
+    describe_streams(&synclist, 2, diagonal);
+    fastukk_array(&array, pair);
+    ASSERT(array.count > 100);
+    describe_array(&array, other);
+    ASSERT_STR_EQ(diagonal, other);
+    fastukk_method = SYNC_ANCHORED;
+    fastukk_sync(&synclist, pair);
+    describe_streams(&synclist, 2, diagonal);
+    fastukk_array(&array, pair);
+    fastukk_method = SYNC_AUTOMATIC;
+    describe_array(&array, other);
+    ASSERT_STR_EQ(diagonal, other);
+    make_texts(texts, 37, 2000, 10, 'a');
+    make_texts(texts + 2, 37, 2000, 15, 'a');
+    synchronize(&synclist, 4, texts);
+    describe_streams(&synclist, 4, diagonal);
+    synchronize_array(&array, 4, texts);
+    describe_array(&array, other);
+    ASSERT_STR_EQ(diagonal, other);
+    for (i = 0; i < 4; i++)
+        text_empty(&texts[i]);
+    text_empty(&pair[0]);
+    text_empty(&pair[1]);
+    fastukk_array(&array, pair);
+    ASSERT_EQ(0, array.count);
+    free_syncarray(&array);
+    PASS();
+}
+
+TEST center_sync_merges_alignments_with_center() {
+    static Text texts[4];
+    Syncarray array;
+    short i;
+
+    cstring_to_text(&texts[0], "the quick brown fox");
+    cstring_to_text(&texts[1], "the quick brwn fox");
+    cstring_to_text(&texts[2], "the quack brown fox");
+    center_sync(&array, 3, texts, 0);
+    describe_array(&array, diagonal);
+    ASSERT_STR_EQ("M0+6/0+6/0+6 U6+1/6+1/6+1 M7+5/7+5/7+5 "
+                  "U12+1/12+0/12+1 M13+6/12+6/13+6 ", diagonal);
+    for (i = 0; i < 3; i++)
+        text_empty(&texts[i]);
+    make_texts(texts, 41, 3000, 10, 'a');
+    make_texts(texts + 2, 41, 3000, 20, 'a');
+    center_sync(&array, 4, texts, -1);
+    ASSERT(array.count > 100);
+    describe_array(&array, diagonal);
+    synchronize_threads = 3;
+    center_sync(&array, 4, texts, -1);
+    synchronize_threads = 1;
+    describe_array(&array, other);
+    ASSERT_STR_EQ(diagonal, other);
+    for (i = 0; i < 4; i++)
+        text_empty(&texts[i]);
+    PASS();
+}
+
+/* Describes the transposed matches in "synclist" and disposes of it. */
+static void describe_transposed(Synclist *synclist, char *buffer) {
+    Sync *sync;
+
+    buffer[0] = '\0';
+    while ((sync = synclist->first)) {
+        if (sync->match)
+            sprintf(buffer + strlen(buffer), "%ld:", *sync->match);
+        sprintf(buffer + strlen(buffer), "%ld+%ld ", sync->substr->start,
+                sync->substr->length);
+        list_remove(synclist, sync);
+    }
+}
+
+TEST transpose_sync_takes_longest_matches_first() {
+    Synclist synclist1, synclist2;
+
+    cstring_to_text(&pair[0], "abcdefgh12345xy");
+    cstring_to_text(&pair[1], "12345zabcdefghxy");
+    transpose_sync(&synclist1, &synclist2, &pair[0], &pair[1]);
+    describe_transposed(&synclist1, diagonal);
+    describe_transposed(&synclist2, other);
+    ASSERT_STR_EQ("1:0+8 2:8+5 3:13+2 ", diagonal);
+    ASSERT_STR_EQ("2:0+5 5+1 1:6+8 3:14+2 ", other);
+    PASS();
+}
+
+SUITE(sync_suite) {
+    SET_SETUP(initialize_texts, (Text*[]) {&pair[0], &pair[1], NULL});
+    SET_TEARDOWN(deinitialize_texts, (Text*[]) {&pair[0], &pair[1], NULL});
+
+    RUN_TEST(bit_parallel_sync_matches_diagonal);
+    RUN_TEST(linear_space_sync_matches_diagonal);
+    RUN_TEST(automatic_sync_matches_diagonal_for_distant_texts);
+    RUN_TEST(threaded_sync_matches_diagonal);
+    RUN_TEST(threaded_context_keeps_its_workers);
+    RUN_TEST(anchored_sync_is_optimal_for_similar_texts);
+    RUN_TEST(anchored_sync_covers_equal_texts);
+    RUN_TEST(anchored_sync_falls_back_for_sparse_anchors);
+    RUN_TEST(line_sync_aligns_only_changed_lines);
+    RUN_TEST(line_sync_handles_texts_without_common_lines);
+    RUN_TEST(approximate_sync_is_optimal_within_max_cost);
+    RUN_TEST(approximate_sync_bounds_its_excess);
+    RUN_TEST(approximate_sync_stays_close_on_a_page);
+    RUN_TEST(bit_parallel_sync_handles_empty_texts);
+    RUN_TEST(limited_sync_stops_beyond_max_edits);
+    RUN_TEST(limited_linear_space_sync_stops_beyond_max_edits);
+    RUN_TEST(contexts_sync_concurrently);
+    RUN_TEST(anchored_sync_divides_gaps_among_threads);
+    RUN_TEST(synchronize_matches_ranges_on_threads);
+    RUN_TEST(syncarray_iterates_as_synclist);
+    RUN_TEST(center_sync_merges_alignments_with_center);
+    RUN_TEST(transpose_sync_takes_longest_matches_first);
+}
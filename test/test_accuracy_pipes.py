@@ -0,0 +1,64 @@
+#!/usr/bin/env python
+# -*- encoding: UTF-8 -*-
+
+"""
+Tests that accuracy gives the same report when the generated file, with
+or without a header, is read from a pipe or is gzip-compressed.
+"""
+
+import subprocess
+import tempfile
+import zlib
+
+import os.path as p
+
+
+# Path to accuracy program
+ACCURACY = p.join(p.dirname(p.dirname(p.realpath(__file__))),
+                  'bin', 'accuracy')
+assert p.exists(ACCURACY), 'Could not find ' + ACCURACY
+
+HEADER = (b'ocreval Vendor-Independent Interface Version 7.0\n'
+          b'------------------------------------------------\n'
+          b'zoning: 1\n'
+          b'------------------------------------------------\n')
+
+CORRECT = u'Ḵ’aawgyaa hllng.aaygi ’laa ḵyaang.aas.\n'.encode('UTF-8')
+GENERATED = u'K’aawgyaa hllng.aaygi  laa kyaang.aas,\n'.encode('UTF-8')
+
+
+def gzip(data):
+    compressor = zlib.compressobj(9, zlib.DEFLATED, 16 + zlib.MAX_WBITS)
+    return compressor.compress(data) + compressor.flush()
+
+
+def accuracy(correct_name, generated_name, stdin=None):
+    process = subprocess.Popen([ACCURACY, correct_name, generated_name],
+                               stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+    report, _ = process.communicate(stdin)
+    assert process.returncode == 0
+    return report
+
+
+if __name__ == '__main__':
+    for generated in (GENERATED, HEADER + GENERATED):
+        with tempfile.NamedTemporaryFile('wb') as correct_file,\
+                tempfile.NamedTemporaryFile('wb') as generated_file:
+            correct_file.write(CORRECT)
+            generated_file.write(generated)
+            correct_file.flush()
+            generated_file.flush()
+
+            expected = accuracy(correct_file.name, generated_file.name)
+            for name in ('-', '/dev/stdin'):
+                actual = accuracy(correct_file.name, name, stdin=generated)
+                assert actual == expected, (name, actual, expected)
+
+            compressed = gzip(generated)
+            generated_file.seek(0)
+            generated_file.truncate()
+            generated_file.write(compressed)
+            generated_file.flush()
+            for name in (generated_file.name, '-'):
+                actual = accuracy(correct_file.name, name, stdin=compressed)
+                assert actual == expected, (name, actual, expected)
@@ -36,6 +36,25 @@ TEST cstring_to_text_should_handle_astral_code_points() {
     PASS();
 }
 
+/* Texts use the narrowest width that holds all of their characters. */
+TEST cstring_to_text_should_widen_as_needed() {
+    ASSERT(cstring_to_text(text, "café"));
+    ASSERT_EQ_FMT(1, (int) text->width, "%d");
+
+    ASSERT(cstring_to_text(text, " łódź"));
+    ASSERT_EQ_FMT(2, (int) text->width, "%d");
+
+    ASSERT(cstring_to_text(text, " 🍮"));
+    ASSERT_EQ_FMT(4, (int) text->width, "%d");
+
+    ASSERT_EQ_FMT(11, text->count, "%d");
+    ASSERT_EQ_FMT(0xE9u, TEXT_VALUE(text, 3), "%u");
+    ASSERT_EQ_FMT(0x142u, TEXT_VALUE(text, 5), "%u");
+    ASSERT_EQ_FMT(0x1F36Eu, TEXT_VALUE(text, 10), "%u");
+
+    PASS();
+}
+
 TEST char_to_string_converts_space() {
     char buffer[STRING_SIZE];
 
@@ -107,6 +126,7 @@ SUITE(cstring_to_text_suite) {
     RUN_TEST(cstring_to_text_should_handle_latin);
     RUN_TEST(cstring_to_text_should_handle_bmp);
     RUN_TEST(cstring_to_text_should_handle_astral_code_points);
+    RUN_TEST(cstring_to_text_should_widen_as_needed);
 }
 
 SUITE(char_to_string_suite) {
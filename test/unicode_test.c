@@ -0,0 +1,33 @@
+#include "greatest.h"
+
+#include <utf8proc.h>
+
+#include <charclass.h>
+#include <unicode.h>
+
+TEST unicode_property_agrees_with_utf8proc() {
+    Charvalue value;
+
+    for (value = 0; value <= 0x10FFFF; value++) {
+        ASSERT_EQ_FMT((int) utf8proc_category((utf8proc_int32_t) value),
+                      (int) UNICODE_CATEGORY(value), "%d");
+        ASSERT_EQ_FMT((Charvalue) utf8proc_tolower((utf8proc_int32_t) value),
+                      UNICODE_LOWERCASE(value), "%u");
+    }
+    PASS();
+}
+
+TEST unicode_property_finds_charclass() {
+    ASSERT_STR_EQ("Unassigned", charclass_name(charclass(0x10FFFF)));
+    ASSERT_STR_EQ("ASCII Spacing Characters", charclass_name(charclass(' ')));
+    ASSERT_STR_EQ("ASCII Digits", charclass_name(charclass('7')));
+    ASSERT_STR_EQ("Latin1 Lowercase Letters",
+                  charclass_name(charclass(0x00DF)));
+    ASSERT_STR_EQ("Specials", charclass_name(charclass(0xFFFD)));
+    PASS();
+}
+
+SUITE(unicode_property_suite) {
+    RUN_TEST(unicode_property_agrees_with_utf8proc);
+    RUN_TEST(unicode_property_finds_charclass);
+}
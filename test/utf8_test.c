@@ -0,0 +1,135 @@
+#include "greatest.h"
+#include "test_utils.h"
+
+#include <text.h>
+#include <utf8.h>
+
+static Decoder decoder_;
+static Decoder *decoder = &decoder_;
+
+static void initialize_decoder(void *unused) {
+    text_initialize(text);
+    decoder_initialize(decoder, text, True, SUSPECT_MARKER);
+}
+
+static void deinitialize_decoder(void *unused) {
+    text_empty(text);
+}
+
+static long decode_string(const char *string, Boolean final) {
+    return decode_utf8(decoder, (unsigned char *) string, strlen(string),
+                       final);
+}
+
+/* Long enough to exercise every block size. */
+#define LONG_ASCII "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ" \
+                   "0123456789 abcdefghijklmnopqrstuvwxyz"
+
+TEST decode_utf8_handles_long_ascii_runs() {
+    long i;
+    const char *expected = LONG_ASCII;
+
+    ASSERT_EQ_FMT(89L, decode_string(LONG_ASCII, True), "%ld");
+    ASSERT_EQ_FMT(89L, text->count, "%ld");
+    for (i = 0; i < text->count; i++) {
+        ASSERT_EQ_FMT((Charvalue) expected[i], TEXT_VALUE(text, i), "%u");
+        ASSERT_FALSE(TEXT_SUSPECT(text, i));
+    }
+
+    PASS();
+}
+
+TEST decode_utf8_handles_mixed_widths() {
+    decode_string(LONG_ASCII "łódź 働 🍮", True);
+
+    ASSERT_EQ_FMT(97L, text->count, "%ld");
+    ASSERT_EQ_FMT(0x0142u, TEXT_VALUE(text, 89), "%u");
+    ASSERT_EQ_FMT(0x50CDu, TEXT_VALUE(text, 94), "%u");
+    ASSERT_EQ_FMT(0x1F36Eu, TEXT_VALUE(text, 96), "%u");
+
+    PASS();
+}
+
+TEST decode_utf8_widens_text_after_ascii_runs() {
+    decode_string(LONG_ASCII "é", False);
+    ASSERT_EQ_FMT(1, (int) text->width, "%d");
+    decode_string(LONG_ASCII "働", False);
+    ASSERT_EQ_FMT(2, (int) text->width, "%d");
+    decode_string(LONG_ASCII, True);
+
+    ASSERT_EQ_FMT(269L, text->count, "%ld");
+    ASSERT_EQ_FMT((Charvalue) 'a', TEXT_VALUE(text, 0), "%u");
+    ASSERT_EQ_FMT(0xE9u, TEXT_VALUE(text, 89), "%u");
+    ASSERT_EQ_FMT(0x50CDu, TEXT_VALUE(text, 179), "%u");
+    ASSERT_EQ_FMT((Charvalue) 'z', TEXT_VALUE(text, 268), "%u");
+
+    PASS();
+}
+
+TEST decode_utf8_marks_suspect_characters() {
+    decode_string(LONG_ASCII "^x^ł" LONG_ASCII, True);
+
+    ASSERT_EQ_FMT(180L, text->count, "%ld");
+    ASSERT_FALSE(TEXT_SUSPECT(text, 88));
+    ASSERT(TEXT_SUSPECT(text, 89));
+    ASSERT(TEXT_SUSPECT(text, 90));
+    ASSERT_FALSE(TEXT_SUSPECT(text, 91));
+
+    PASS();
+}
+
+TEST decode_utf8_leaves_incomplete_sequences() {
+    /* The first two bytes of U+50CD. */
+    ASSERT_EQ_FMT(3L, decode_string("abc\xE5\x83", False), "%ld");
+    ASSERT_EQ_FMT(3L, text->count, "%ld");
+
+    ASSERT_EQ_FMT(4L, decode_string("\xE5\x83\x8D!", True), "%ld");
+    ASSERT_EQ_FMT(5L, text->count, "%ld");
+    ASSERT_EQ_FMT(0x50CDu, TEXT_VALUE(text, 3), "%u");
+
+    PASS();
+}
+
+TEST find_invalid_utf8_accepts_valid_text() {
+    const char *string = LONG_ASCII "łódź 働 🍮" LONG_ASCII;
+    ASSERT_EQ_FMT(-1L, find_invalid_utf8((unsigned char *) string,
+                                         (long) strlen(string)), "%ld");
+    PASS();
+}
+
+TEST find_invalid_utf8_finds_offset_of_invalid_sequence() {
+    /* Lone continuation byte. */
+    const char *string = LONG_ASCII "\x8D" LONG_ASCII;
+    ASSERT_EQ_FMT(89L, find_invalid_utf8((unsigned char *) string,
+                                         (long) strlen(string)), "%ld");
+
+    /* Overlong encoding of '/'. */
+    string = LONG_ASCII "ł\xC0\xAF";
+    ASSERT_EQ_FMT(91L, find_invalid_utf8((unsigned char *) string,
+                                         (long) strlen(string)), "%ld");
+
+    /* Encoded surrogate. */
+    string = "ab\xED\xA0\x80";
+    ASSERT_EQ_FMT(2L, find_invalid_utf8((unsigned char *) string,
+                                        (long) strlen(string)), "%ld");
+
+    /* Truncated at the end of input. */
+    string = LONG_ASCII "\xF0\x9F\x8D";
+    ASSERT_EQ_FMT(89L, find_invalid_utf8((unsigned char *) string,
+                                         (long) strlen(string)), "%ld");
+
+    PASS();
+}
+
+SUITE(decode_utf8_suite) {
+    SET_SETUP(initialize_decoder, NULL);
+    SET_TEARDOWN(deinitialize_decoder, NULL);
+
+    RUN_TEST(decode_utf8_handles_long_ascii_runs);
+    RUN_TEST(decode_utf8_handles_mixed_widths);
+    RUN_TEST(decode_utf8_widens_text_after_ascii_runs);
+    RUN_TEST(decode_utf8_marks_suspect_characters);
+    RUN_TEST(decode_utf8_leaves_incomplete_sequences);
+    RUN_TEST(find_invalid_utf8_accepts_valid_text);
+    RUN_TEST(find_invalid_utf8_finds_offset_of_invalid_sequence);
+}
@@ -8,7 +8,7 @@ LOCAL_LINK_DIR := $(abspath $(TOP)lib)
 LIBOCREVAL = $(LOCAL_LINK_DIR)/libocreval.a
 
 # Compilation flags for all files.
-override CFLAGS += -ansi
+override CFLAGS += -ansi -pthread
 # X/Open 6.0 standardizes features used in this K&R C source...
 CPPDEFINES = -D_XOPEN_SOURCE=600
 # Create dependency files.
@@ -16,7 +16,7 @@ CPPFLAGS = -MMD
 # utf8proc lib usually lives in here:
 override CPPFLAGS += -I/usr/local/include $(CPPDEFINES)
 LDFLAGS += -L/usr/local/lib
-LDLIBS = -lm -lutf8proc
+LDLIBS = -lm -lutf8proc -lz -lpthread
 
 # Use libocreval, created in lib/
 override CPPFLAGS += -I$(LOCAL_INCLUDE_DIR)